@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "AimPredictor.h"
+
+AimPredictor::AimPredictor() : m_submitted(0), m_middle(2) {
+    m_worker = std::thread([this] { Run(); });
+}
+
+AimPredictor::~AimPredictor() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+uint64_t AimPredictor::Submit(std::shared_ptr<const LevelSnapshot> snapshot, float power, float angle, int maxContacts) {
+    Request request;
+    request.snapshot = std::move(snapshot);
+    request.power = power;
+    request.angle = angle;
+    request.maxContacts = maxContacts;
+    request.sequence = m_submitted.load(std::memory_order_relaxed) + 1;
+    request.issued = Clock::now();
+    const uint64_t sequence = request.sequence;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_request = std::move(request);
+        m_hasRequest = true;
+        m_submitted.store(sequence, std::memory_order_relaxed);
+    }
+    m_wake.notify_one();
+    return sequence;
+}
+
+void AimPredictor::Run() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_hasRequest; });
+            if (m_stopping) return;
+            request = std::move(m_request);
+            m_hasRequest = false;
+        }
+
+        ShotSimulator::ShotOptions options = ShotSimulator::ShotOptions::Preview(request.maxContacts);
+        options.step *= COARSE_STEPS;
+        Publish(request, ShotSimulator::SimulateShot(*request.snapshot, request.power, request.angle, options), false);
+
+        // Superseded while the coarse pass ran: start on the newer request instead
+        if (m_submitted.load(std::memory_order_relaxed) != request.sequence) continue;
+
+        options.step /= COARSE_STEPS;
+        Publish(request, ShotSimulator::SimulateShot(*request.snapshot, request.power, request.angle, options), true);
+    }
+}
+
+void AimPredictor::Publish(const Request& request, ShotSimulator::ShotOutcome&& outcome, bool refined) {
+    Result& slot = m_slots[m_writeSlot];
+    slot.outcome = std::move(outcome);
+    slot.sequence = request.sequence;
+    slot.refined = refined;
+    slot.issued = request.issued;
+
+    // Release: the reader that picks this slot up sees everything written above
+    int previous = m_middle.exchange(m_writeSlot | FRESH_BIT, std::memory_order_acq_rel);
+    m_writeSlot = previous & SLOT_MASK;
+}
+
+const AimPredictor::Result* AimPredictor::Latest() {
+    if (m_middle.load(std::memory_order_relaxed) & FRESH_BIT) {
+        int previous = m_middle.exchange(m_readSlot, std::memory_order_acq_rel);
+        m_readSlot = previous & SLOT_MASK;
+
+        const Result& result = m_slots[m_readSlot];
+        float ms = std::chrono::duration<float, std::milli>(Clock::now() - result.issued).count();
+        if (result.sequence != m_lastSeenSequence) {
+            Record(m_firstPathLatency, ms);
+            m_lastSeenSequence = result.sequence;
+        }
+        if (result.refined) {
+            Record(m_fullPathLatency, ms);
+        }
+    }
+
+    const Result& current = m_slots[m_readSlot];
+    return current.sequence != 0 ? &current : nullptr;
+}
+
+void AimPredictor::Record(LatencyStats& stats, float ms) {
+    stats.samples++;
+    stats.lastMs = ms;
+    stats.totalMs += ms;
+    if (ms > stats.maxMs) stats.maxMs = ms;
+}
+
+void AimPredictor::ResetLatency() {
+    m_firstPathLatency = LatencyStats{ 0, 0.0f, 0.0f, 0.0f };
+    m_fullPathLatency = LatencyStats{ 0, 0.0f, 0.0f, 0.0f };
+}
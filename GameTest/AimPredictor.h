@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "LevelSnapshot.h"
+#include "ShotSimulator.h"
+
+// Plays aim previews on its own worker thread so Render() never waits for a
+// simulation. Submit() hands over the newest request (latest wins: a request
+// the worker hasn't started is simply replaced). The worker publishes a coarse
+// path first, then the full-resolution one unless a newer request arrived.
+//
+// Results are handed back through three slots: the worker writes one, the
+// render thread reads one, and the third is swapped between them with a single
+// atomic exchange. Neither side ever blocks, and the slot being drawn is never
+// written. (With only two slots the worker would have to wait for the reader.)
+class AimPredictor {
+public:
+    static constexpr int COARSE_STEPS = 4;      // Game ticks per step in the coarse pass
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        ShotSimulator::ShotOutcome outcome;
+        uint64_t sequence = 0;      // Submit() number it answers; 0 = empty slot
+        bool refined = false;       // Full resolution rather than the coarse pass
+        Clock::time_point issued;
+    };
+
+    // Submit() to the frame Latest() first returns the result
+    struct LatencyStats {
+        long long samples;
+        float lastMs;
+        float totalMs;
+        float maxMs;
+
+        float AverageMs() const { return samples > 0 ? totalMs / samples : 0.0f; }
+    };
+
+    AimPredictor();
+    ~AimPredictor();
+
+    AimPredictor(const AimPredictor&) = delete;
+    AimPredictor& operator=(const AimPredictor&) = delete;
+
+    uint64_t Submit(std::shared_ptr<const LevelSnapshot> snapshot, float power, float angle, int maxContacts);
+
+    // Newest published result, or nullptr before the first one. Render thread
+    // only; the result stays valid until the next call.
+    const Result* Latest();
+
+    const LatencyStats& GetFirstPathLatency() const { return m_firstPathLatency; }
+    const LatencyStats& GetFullPathLatency() const { return m_fullPathLatency; }
+    void ResetLatency();
+
+private:
+    struct Request {
+        std::shared_ptr<const LevelSnapshot> snapshot;
+        float power;
+        float angle;
+        int maxContacts;
+        uint64_t sequence;
+        Clock::time_point issued;
+    };
+
+    static constexpr int SLOT_MASK = 3;
+    static constexpr int FRESH_BIT = 4;     // Set in m_middle when it holds an unread result
+
+    void Run();
+    void Publish(const Request& request, ShotSimulator::ShotOutcome&& outcome, bool refined);
+    static void Record(LatencyStats& stats, float ms);
+
+    // Mailbox
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    Request m_request;
+    bool m_hasRequest = false;
+    bool m_stopping = false;
+    std::atomic<uint64_t> m_submitted;      // Sequence of the newest Submit()
+
+    // Result slots
+    Result m_slots[3];
+    int m_writeSlot = 0;                    // Worker only
+    int m_readSlot = 1;                     // Render thread only
+    std::atomic<int> m_middle;
+
+    // Render thread only
+    uint64_t m_lastSeenSequence = 0;
+    LatencyStats m_firstPathLatency = { 0, 0.0f, 0.0f, 0.0f };
+    LatencyStats m_fullPathLatency = { 0, 0.0f, 0.0f, 0.0f };
+
+    std::thread m_worker;                   // Last, so everything above exists before it starts
+};
@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "AimPredictor.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+    std::shared_ptr<const LevelSnapshot> MakeCourse() {
+        auto level = std::make_shared<LevelSnapshot>();
+        level->world.width = 1024.0f;
+        level->world.height = 768.0f;
+        level->world.AddWall(BallPhysics::MakeOrientedBox(400.0f, 300.0f, 20.0f, 300.0f, 0.0f));
+        level->world.AddWall(BallPhysics::MakeOrientedBox(650.0f, 500.0f, 240.0f, 20.0f, 30.0f));
+        level->world.hole = { 880.0f, 600.0f, 10.0f, 200.0f, true };
+
+        EnemySnapshot circling = {};
+        circling.patrol = { PatrolPattern::Circular, 600.0f, 250.0f, 40.0f, 60.0f, 0.0f };
+        circling.radius = 15.0f;
+        circling.active = true;
+        circling.patrol.Evaluate(circling.angle, circling.time, circling.x, circling.y);
+        level->enemies.push_back(circling);
+
+        level->ball.x = level->startX = 150.0f;
+        level->ball.y = level->startY = 400.0f;
+        return level;
+    }
+}
+
+// The refined path the worker publishes is the one a direct preview
+// simulation of the same request gives
+SELFTEST_CASE(AimPredictor_PublishesDirectSimulation) {
+    const int MAX_CONTACTS = 5;
+    const float AIMS[][2] = { { 60.0f, 0.3f }, { 90.0f, -0.4f }, { 40.0f, 2.5f } };
+
+    const std::shared_ptr<const LevelSnapshot> level = MakeCourse();
+    AimPredictor predictor;
+    for (const auto& aim : AIMS) {
+        const uint64_t sequence = predictor.Submit(level, aim[0], aim[1], MAX_CONTACTS);
+
+        const AimPredictor::Result* result = nullptr;
+        const auto deadline = AimPredictor::Clock::now() + std::chrono::seconds(5);
+        while (AimPredictor::Clock::now() < deadline) {
+            result = predictor.Latest();
+            if (result && result->sequence == sequence && result->refined) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!SELFTEST_CHECK(context, result && result->sequence == sequence && result->refined)) return;
+
+        const ShotSimulator::ShotOutcome direct =
+            ShotSimulator::SimulateShot(*level, aim[0], aim[1], ShotSimulator::ShotOptions::Preview(MAX_CONTACTS));
+        const ShotSimulator::ShotOutcome& published = result->outcome;
+        bool samePath = published.path.size() == direct.path.size();
+        for (size_t i = 0; samePath && i < direct.path.size(); i++) {
+            samePath = published.path[i].x == direct.path[i].x && published.path[i].y == direct.path[i].y;
+        }
+        SELFTEST_CHECK(context, samePath);
+        SELFTEST_CHECK(context, published.finalX == direct.finalX && published.finalY == direct.finalY &&
+                                published.holed == direct.holed && published.wallHits == direct.wallHits &&
+                                published.enemyContacts.size() == direct.enemyContacts.size());
+        context.Log("power %.0f angle %.1f: %zu path points, %d wall hits",
+                    aim[0], aim[1], direct.path.size(), direct.wallHits);
+    }
+}
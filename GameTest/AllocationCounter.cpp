@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // The innermost counter on this thread; nullptr costs one TLS read per allocation
+    thread_local long long* t_count = nullptr;
+
+    void* Allocate(size_t size) {
+        if (t_count) ++*t_count;
+        // malloc(0) may return nullptr; operator new must not
+        return malloc(size ? size : 1);
+    }
+
+#if defined(__cpp_aligned_new)
+    // Blocks from here must go back through FreeAligned, not free
+    void* AllocateAligned(size_t size, std::align_val_t alignment) {
+        if (t_count) ++*t_count;
+        size_t bytes = static_cast<size_t>(alignment);
+#if defined(_MSC_VER)
+        return _aligned_malloc(size ? size : 1, bytes);
+#else
+        if (bytes < sizeof(void*)) bytes = sizeof(void*);
+        void* block = nullptr;
+        return posix_memalign(&block, bytes, size ? size : 1) == 0 ? block : nullptr;
+#endif
+    }
+
+    void FreeAligned(void* block) {
+#if defined(_MSC_VER)
+        _aligned_free(block);
+#else
+        free(block);
+#endif
+    }
+#endif
+}
+
+AllocationCounter::AllocationCounter() : m_outer(t_count) {
+    t_count = &m_count;
+}
+
+AllocationCounter::~AllocationCounter() {
+    t_count = m_outer;
+    if (m_outer) *m_outer += m_count;
+}
+
+// Replacements for every global allocation and deallocation function, so
+// none of the library's defaults (which would pair a different heap with
+// ours) is ever used. Outside an AllocationCounter they are plain
+// malloc/free behind one TLS read.
+void* operator new(size_t size) {
+    void* block = Allocate(size);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    free(block);
+}
+
+#if defined(__cpp_aligned_new)
+// Over-aligned types, C++17 and later
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* block = AllocateAligned(size, alignment);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    FreeAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    FreeAligned(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept {
+    FreeAligned(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept {
+    FreeAligned(block);
+}
+
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(block);
+}
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+// Counts the heap allocations (operator new, in every form) made on the
+// constructing thread while it lives. Global operator new/delete are
+// replaced in AllocationCounter.cpp, so this works in release builds as
+// well as under the debug CRT. Other threads are never counted, so pipeline
+// and pool workers busy at the same time don't show up. Counters nest: an
+// inner one's allocations are added to the outer one when it goes.
+class AllocationCounter {
+public:
+    AllocationCounter();
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    long long Get() const { return m_count; }
+
+private:
+    long long m_count = 0;
+    long long* m_outer;         // The enclosing counter's count, if any
+};
@@ -39,11 +39,11 @@ CSimpleSprite::CSimpleSprite(const char *fileName, const unsigned int nColumns,
 	}
 }
 
-void CSimpleSprite::Update(const float dt)
+void CSimpleSprite::Update(const SimSeconds dt)
 {
     if (m_currentAnim >= 0)
     {
-        m_animTime += dt/1000.0f;
+        m_animTime += dt.count();
         sAnimation &anim = m_animations[m_currentAnim];
         float duration = anim.m_speed * anim.m_frames.size();
 
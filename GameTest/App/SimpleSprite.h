@@ -6,6 +6,7 @@
 #define _SIMPLESPRITE_H_
 
 #include "../glut/include/GL/freeglut.h"
+#include "../SimClock.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -18,7 +19,7 @@ class CSimpleSprite
 public:
     // If width, height and UV coords are not provided then they will be derived from the texture size.
     CSimpleSprite(const char *fileName, const unsigned int nColumns = 1, const unsigned int nRows = 1);
-    void Update(const float dt);
+    void Update(const SimSeconds dt);
     void Draw();
     void SetPosition(const float x, const float y) { m_xpos = x; m_ypos = y; }   
     void SetAngle(const float a)  { m_angle = a; }
@@ -37,6 +37,9 @@ extern void Init();
 extern void Update(const float deltaTime);
 extern void Render();
 extern void Shutdown();
+// Handles headless runs (self tests, benchmarks) before any window opens.
+// Returns true if the command line asked for one; the process then exits with exitCode.
+extern bool RunCommandLine(const wchar_t* commandLine, int& exitCode);
 //---------------------------------------------------------------------------------
 void StartCounter()
 {
@@ -171,6 +174,12 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, 	_In_opt_ HINSTANCE hPrevInstanc
 {	
 	int argc = 0;	char* argv = "";
 
+	int commandLineResult = 0;
+	if (RunCommandLine(lpCmdLine, commandLineResult))
+	{
+		return commandLineResult;
+	}
+
 	// Exit handler to check memory on exit.
 	const int result_1 = std::atexit(CheckMemCallback);
 
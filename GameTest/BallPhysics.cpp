@@ -0,0 +1,760 @@
+#include "stdafx.h"
+#include "BallPhysics.h"
+#include <cmath>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BALLPHYSICS_SSE2
+#endif
+
+namespace BallPhysics {
+
+    namespace {
+        const float CONTACT_EPSILON = 0.01f;  // Stop just short of a surface so overlap tests stay quiet
+        const int MAX_BOUNCES_PER_STEP = 4;
+        const int MAX_WALL_CANDIDATES = 32;     // Past this the sweeps just scan every wall
+        const float PADDING_LANE_CENTER = 1e18f;
+        const float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+        // Distance rolled before speed decays from `speed` to `targetSpeed`.
+        float DistanceToSpeed(float speed, float targetSpeed) {
+            if (speed <= targetSpeed) return 0.0f;
+            return logf(speed / targetSpeed) / FRICTION_COEFFICIENT;
+        }
+
+        void Reflect(BallState& ball, float normalX, float normalY, float dampening) {
+            float along = ball.vx * normalX + ball.vy * normalY;
+            if (along >= 0.0f) return;
+            ball.vx -= (1.0f + dampening) * along * normalX;
+            ball.vy -= (1.0f + dampening) * along * normalY;
+        }
+
+        // Distance along unit (dirX, dirY) to the first screen edge the ball
+        // reaches, if that is under `limit`, and the edge's inward normal
+        bool SweepBoundary(const BallState& ball, const PhysicsWorld& world, float dirX, float dirY, float limit,
+                           float& distance, float& normalX, float& normalY) {
+            bool hit = false;
+            distance = limit;
+            if (dirX > 0.0f) {
+                float d = (world.width - ball.radius - ball.x) / dirX;
+                if (d < distance) { distance = d > 0.0f ? d : 0.0f; hit = true; normalX = -1.0f; normalY = 0.0f; }
+            } else if (dirX < 0.0f) {
+                float d = (ball.radius - ball.x) / dirX;
+                if (d < distance) { distance = d > 0.0f ? d : 0.0f; hit = true; normalX = 1.0f; normalY = 0.0f; }
+            }
+            if (dirY > 0.0f) {
+                float d = (world.height - ball.radius - ball.y) / dirY;
+                if (d < distance) { distance = d > 0.0f ? d : 0.0f; hit = true; normalX = 0.0f; normalY = -1.0f; }
+            } else if (dirY < 0.0f) {
+                float d = (ball.radius - ball.y) / dirY;
+                if (d < distance) { distance = d > 0.0f ? d : 0.0f; hit = true; normalX = 0.0f; normalY = 1.0f; }
+            }
+            return hit;
+        }
+
+#if !defined(BALLPHYSICS_SSE2)
+        // Squared distance from a point to lane `i`'s box, measured in the box's frame
+        float LaneDistanceSquared(const WallLanes& walls, int i, float x, float y) {
+            float dx = x - walls.centerX[i];
+            float dy = y - walls.centerY[i];
+            float localX = dx * walls.cosAngle[i] + dy * walls.sinAngle[i];
+            float localY = dy * walls.cosAngle[i] - dx * walls.sinAngle[i];
+            float gapX = fabsf(localX) - walls.halfWidth[i];
+            float gapY = fabsf(localY) - walls.halfHeight[i];
+            gapX = gapX > 0.0f ? gapX : 0.0f;
+            gapY = gapY > 0.0f ? gapY : 0.0f;
+            return gapX * gapX + gapY * gapY;
+        }
+#endif
+
+        // Walls a circle could touch while moving `distance` along a unit
+        // direction: those overlapping the circle around the path's midpoint
+        // that encloses the whole swept capsule. Returns -1 when there are more
+        // than MAX_WALL_CANDIDATES, meaning every wall is a candidate.
+        int SweepCandidates(const PhysicsWorld& world, float x, float y, float dirX, float dirY,
+                            float distance, float radius, int* out) {
+            float half = distance * 0.5f;
+            int found = FindWallOverlaps(world.wallLanes, x + dirX * half, y + dirY * half,
+                                         radius + half + CONTACT_EPSILON, out, MAX_WALL_CANDIDATES);
+            return found > MAX_WALL_CANDIDATES ? -1 : found;
+        }
+
+        // World-space ball into a box's local frame and back
+        void ToBoxFrame(const OrientedBox& box, BallState& ball) {
+            float dx = ball.x - box.centerX;
+            float dy = ball.y - box.centerY;
+            float vx = ball.vx;
+            float vy = ball.vy;
+            ball.x = dx * box.cosAngle + dy * box.sinAngle;
+            ball.y = dy * box.cosAngle - dx * box.sinAngle;
+            ball.vx = vx * box.cosAngle + vy * box.sinAngle;
+            ball.vy = vy * box.cosAngle - vx * box.sinAngle;
+        }
+
+        void FromBoxFrame(const OrientedBox& box, BallState& ball) {
+            float lx = ball.x;
+            float ly = ball.y;
+            float vx = ball.vx;
+            float vy = ball.vy;
+            ball.x = box.centerX + lx * box.cosAngle - ly * box.sinAngle;
+            ball.y = box.centerY + lx * box.sinAngle + ly * box.cosAngle;
+            ball.vx = vx * box.cosAngle - vy * box.sinAngle;
+            ball.vy = vx * box.sinAngle + vy * box.cosAngle;
+        }
+    }
+
+    OrientedBox MakeOrientedBox(float centerX, float centerY, float width, float height, float rotationDegrees) {
+        OrientedBox box = { centerX, centerY, width / 2, height / 2, 1.0f, 0.0f };
+
+        // Quarter turns stay axis-aligned with the extents swapped, so they keep
+        // the exact box maths instead of picking up cos(90) = -4e-8 noise
+        float quarterTurns = rotationDegrees / 90.0f;
+        if (quarterTurns == floorf(quarterTurns)) {
+            if (fmodf(fabsf(quarterTurns), 2.0f) == 1.0f) {
+                std::swap(box.halfWidth, box.halfHeight);
+            }
+            return box;
+        }
+
+        box.cosAngle = cosf(rotationDegrees * DEGREES_TO_RADIANS);
+        box.sinAngle = sinf(rotationDegrees * DEGREES_TO_RADIANS);
+        return box;
+    }
+
+    bool IsAxisAligned(const OrientedBox& box) {
+        return box.cosAngle == 1.0f && box.sinAngle == 0.0f;
+    }
+
+    WallBox GetBoundingBox(const OrientedBox& box) {
+        if (IsAxisAligned(box)) {
+            return WallBox{ box.centerX - box.halfWidth, box.centerY - box.halfHeight,
+                            box.centerX + box.halfWidth, box.centerY + box.halfHeight };
+        }
+        float c = fabsf(box.cosAngle);
+        float s = fabsf(box.sinAngle);
+        float extentX = c * box.halfWidth + s * box.halfHeight;
+        float extentY = s * box.halfWidth + c * box.halfHeight;
+        return WallBox{ box.centerX - extentX, box.centerY - extentY, box.centerX + extentX, box.centerY + extentY };
+    }
+
+    void WallLanes::Add(const OrientedBox& box) {
+        if (count % WALL_LANES == 0) {
+            // Open a new group of padding lanes: zero-size boxes nothing can reach
+            const int padded = count + WALL_LANES;
+            centerX.resize(padded, PADDING_LANE_CENTER);
+            centerY.resize(padded, PADDING_LANE_CENTER);
+            halfWidth.resize(padded, 0.0f);
+            halfHeight.resize(padded, 0.0f);
+            cosAngle.resize(padded, 1.0f);
+            sinAngle.resize(padded, 0.0f);
+        }
+        centerX[count] = box.centerX;
+        centerY[count] = box.centerY;
+        halfWidth[count] = box.halfWidth;
+        halfHeight[count] = box.halfHeight;
+        cosAngle[count] = box.cosAngle;
+        sinAngle[count] = box.sinAngle;
+        count++;
+    }
+
+    void WallLanes::RemoveSwap(int index) {
+        const int last = count - 1;
+        centerX[index] = centerX[last];
+        centerY[index] = centerY[last];
+        halfWidth[index] = halfWidth[last];
+        halfHeight[index] = halfHeight[last];
+        cosAngle[index] = cosAngle[last];
+        sinAngle[index] = sinAngle[last];
+
+        // The freed lane goes back to padding; an empty group is dropped
+        centerX[last] = PADDING_LANE_CENTER;
+        centerY[last] = PADDING_LANE_CENTER;
+        halfWidth[last] = 0.0f;
+        halfHeight[last] = 0.0f;
+        cosAngle[last] = 1.0f;
+        sinAngle[last] = 0.0f;
+        count = last;
+        if (count % WALL_LANES == 0) {
+            centerX.resize(count);
+            centerY.resize(count);
+            halfWidth.resize(count);
+            halfHeight.resize(count);
+            cosAngle.resize(count);
+            sinAngle.resize(count);
+        }
+    }
+
+    void WallLanes::Clear() {
+        centerX.clear();
+        centerY.clear();
+        halfWidth.clear();
+        halfHeight.clear();
+        cosAngle.clear();
+        sinAngle.clear();
+        count = 0;
+    }
+
+    int FindWallOverlaps(const WallLanes& walls, float x, float y, float radius, int* out, int maxOut) {
+        const int padded = static_cast<int>(walls.centerX.size());
+        const float radiusSquared = radius * radius;
+        int found = 0;
+
+#if defined(BALLPHYSICS_SSE2)
+        const __m128 px = _mm_set1_ps(x);
+        const __m128 py = _mm_set1_ps(y);
+        const __m128 r2 = _mm_set1_ps(radiusSquared);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        for (int i = 0; i < padded; i += WALL_LANES) {
+            __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(&walls.centerX[i]));
+            __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(&walls.centerY[i]));
+            __m128 c = _mm_loadu_ps(&walls.cosAngle[i]);
+            __m128 s = _mm_loadu_ps(&walls.sinAngle[i]);
+            __m128 localX = _mm_add_ps(_mm_mul_ps(dx, c), _mm_mul_ps(dy, s));
+            __m128 localY = _mm_sub_ps(_mm_mul_ps(dy, c), _mm_mul_ps(dx, s));
+
+            __m128 gapX = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, localX), _mm_loadu_ps(&walls.halfWidth[i])), zero);
+            __m128 gapY = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, localY), _mm_loadu_ps(&walls.halfHeight[i])), zero);
+            __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(gapX, gapX), _mm_mul_ps(gapY, gapY));
+
+            int mask = _mm_movemask_ps(_mm_cmplt_ps(distanceSquared, r2));
+            for (int lane = 0; mask != 0; lane++, mask >>= 1) {
+                if (mask & 1) {
+                    if (found < maxOut) out[found] = i + lane;
+                    found++;
+                }
+            }
+        }
+#else
+        for (int i = 0; i < padded; i++) {
+            if (LaneDistanceSquared(walls, i, x, y) < radiusSquared) {
+                if (found < maxOut) out[found] = i;
+                found++;
+            }
+        }
+#endif
+        return found;
+    }
+
+    bool CircleOverlapsBox(const OrientedBox& box, float x, float y, float radius) {
+        float dx = x - box.centerX;
+        float dy = y - box.centerY;
+        float gapX = fabsf(dx * box.cosAngle + dy * box.sinAngle) - box.halfWidth;
+        float gapY = fabsf(dy * box.cosAngle - dx * box.sinAngle) - box.halfHeight;
+        gapX = gapX > 0.0f ? gapX : 0.0f;
+        gapY = gapY > 0.0f ? gapY : 0.0f;
+        return gapX * gapX + gapY * gapY < radius * radius;
+    }
+
+    bool SweepCircleOrientedBox(float ox, float oy, float dirX, float dirY, float maxDistance, float radius,
+                                const OrientedBox& wall, float& distance, float& normalX, float& normalY) {
+        if (IsAxisAligned(wall)) {
+            return SweepCircleBox(ox, oy, dirX, dirY, maxDistance, radius, GetBoundingBox(wall),
+                                  distance, normalX, normalY);
+        }
+
+        // Sweep in the box's frame, where it is an ordinary WallBox, and rotate the normal back
+        float dx = ox - wall.centerX;
+        float dy = oy - wall.centerY;
+        float localX = dx * wall.cosAngle + dy * wall.sinAngle;
+        float localY = dy * wall.cosAngle - dx * wall.sinAngle;
+        float localDirX = dirX * wall.cosAngle + dirY * wall.sinAngle;
+        float localDirY = dirY * wall.cosAngle - dirX * wall.sinAngle;
+        const WallBox local = { -wall.halfWidth, -wall.halfHeight, wall.halfWidth, wall.halfHeight };
+
+        float localNormalX, localNormalY;
+        if (!SweepCircleBox(localX, localY, localDirX, localDirY, maxDistance, radius, local,
+                            distance, localNormalX, localNormalY)) {
+            return false;
+        }
+        normalX = localNormalX * wall.cosAngle - localNormalY * wall.sinAngle;
+        normalY = localNormalX * wall.sinAngle + localNormalY * wall.cosAngle;
+        return true;
+    }
+
+    bool SweepCircleBox(float ox, float oy, float dirX, float dirY, float maxDistance, float radius,
+                        const WallBox& wall, float& distance, float& normalX, float& normalY) {
+        // Already touching or overlapping: that's ResolveWallOverlap's job
+        float closestX = ox < wall.left ? wall.left : (ox > wall.right ? wall.right : ox);
+        float closestY = oy < wall.top ? wall.top : (oy > wall.bottom ? wall.bottom : oy);
+        float gapX = ox - closestX;
+        float gapY = oy - closestY;
+        if (gapX * gapX + gapY * gapY < radius * radius) return false;
+
+        // Cheap reject: the swept segment's bounds against the box grown by the radius
+        if ((dirX > 0.0f ? ox + dirX * maxDistance : ox) + radius < wall.left ||
+            (dirX < 0.0f ? ox + dirX * maxDistance : ox) - radius > wall.right ||
+            (dirY > 0.0f ? oy + dirY * maxDistance : oy) + radius < wall.top ||
+            (dirY < 0.0f ? oy + dirY * maxDistance : oy) - radius > wall.bottom) {
+            return false;
+        }
+
+        // The swept circle hits the box's Minkowski sum with the circle: four
+        // faces pushed out by the radius plus a quarter circle at each corner.
+        float best = maxDistance;
+        bool hit = false;
+
+        if (dirX > 0.0f) {
+            float t = (wall.left - radius - ox) / dirX;
+            float y = oy + dirY * t;
+            if (t >= 0.0f && t <= best && y >= wall.top && y <= wall.bottom) {
+                best = t; normalX = -1.0f; normalY = 0.0f; hit = true;
+            }
+        } else if (dirX < 0.0f) {
+            float t = (wall.right + radius - ox) / dirX;
+            float y = oy + dirY * t;
+            if (t >= 0.0f && t <= best && y >= wall.top && y <= wall.bottom) {
+                best = t; normalX = 1.0f; normalY = 0.0f; hit = true;
+            }
+        }
+        if (dirY > 0.0f) {
+            float t = (wall.top - radius - oy) / dirY;
+            float x = ox + dirX * t;
+            if (t >= 0.0f && t <= best && x >= wall.left && x <= wall.right) {
+                best = t; normalX = 0.0f; normalY = -1.0f; hit = true;
+            }
+        } else if (dirY < 0.0f) {
+            float t = (wall.bottom + radius - oy) / dirY;
+            float x = ox + dirX * t;
+            if (t >= 0.0f && t <= best && x >= wall.left && x <= wall.right) {
+                best = t; normalX = 0.0f; normalY = 1.0f; hit = true;
+            }
+        }
+
+        const float cornersX[4] = { wall.left, wall.right, wall.right, wall.left };
+        const float cornersY[4] = { wall.top, wall.top, wall.bottom, wall.bottom };
+        for (int i = 0; i < 4; i++) {
+            float px = ox - cornersX[i];
+            float py = oy - cornersY[i];
+            float b = px * dirX + py * dirY;
+            if (b >= 0.0f) continue;  // Moving away from this corner
+            float c = px * px + py * py - radius * radius;
+            float disc = b * b - c;
+            if (disc < 0.0f) continue;
+            float t = -b - sqrtf(disc);
+            if (t >= 0.0f && t <= best) {
+                best = t;
+                normalX = (px + dirX * t) / radius;
+                normalY = (py + dirY * t) / radius;
+                hit = true;
+            }
+        }
+
+        if (hit) distance = best;
+        return hit;
+    }
+
+    void Stop(BallState& ball) {
+        ball.moving = false;
+        ball.vx = 0.0f;
+        ball.vy = 0.0f;
+    }
+
+    bool ResolveBallContact(BallBody& a, BallBody& b) {
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float minDistance = a.radius + b.radius;
+        float distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared >= minDistance * minDistance) return false;
+
+        // Coincident centres: push apart along x rather than dividing by zero
+        float distance = sqrtf(distanceSquared);
+        float nx = distance > 1e-6f ? dx / distance : 1.0f;
+        float ny = distance > 1e-6f ? dy / distance : 0.0f;
+
+        float rvx = b.vx - a.vx;
+        float rvy = b.vy - a.vy;
+        float velAlongNormal = rvx * nx + rvy * ny;
+        if (velAlongNormal > 0.0f) return false;
+
+        float j = -(1.0f + BALL_RESTITUTION) * velAlongNormal;
+        j /= 1.0f / a.mass + 1.0f / b.mass;
+
+        float impulseX = j * nx;
+        float impulseY = j * ny;
+        a.vx -= impulseX / a.mass;
+        a.vy -= impulseY / a.mass;
+        b.vx += impulseX / b.mass;
+        b.vy += impulseY / b.mass;
+
+        // Cap velocities after collision
+        BallBody* bodies[] = { &a, &b };
+        for (BallBody* body : bodies) {
+            float speed = sqrtf(body->vx * body->vx + body->vy * body->vy);
+            if (speed > MAX_COLLISION_VELOCITY) {
+                float scale = MAX_COLLISION_VELOCITY / speed;
+                body->vx *= scale;
+                body->vy *= scale;
+            }
+        }
+
+        float overlap = minDistance - distance;
+        float moveX = overlap * nx * 0.5f;
+        float moveY = overlap * ny * 0.5f;
+        a.x -= moveX;
+        a.y -= moveY;
+        b.x += moveX;
+        b.y += moveY;
+        return true;
+    }
+
+    void LaunchVelocity(float power, float angle, float speedMultiplier, float& vx, float& vy) {
+        float speed = (power / MAX_DRAG_LENGTH) * LAUNCH_SPEED * speedMultiplier;
+        vx = speed * cosf(angle);
+        vy = speed * sinf(angle);
+    }
+
+    void StepFixed(BallState& ball, const PhysicsWorld& world, float dt) {
+        if (!ball.moving) return;
+
+        // Apply velocity caps
+        float speed = sqrtf(ball.vx * ball.vx + ball.vy * ball.vy);
+        if (speed > MAX_VELOCITY) {
+            float scale = MAX_VELOCITY / speed;
+            ball.vx *= scale;
+            ball.vy *= scale;
+            speed = MAX_VELOCITY;
+        }
+
+        // Apply friction. Uses the exact per-step decay s/(1 + k*s*dt) rather than
+        // s - k*s*s*dt: the explicit form reverses the ball once k*s*dt > 1, which
+        // a max-power shot reaches at steps longer than ~1/94s.
+        if (speed > 0.0f) {
+            float decay = 1.0f / (1.0f + FRICTION_COEFFICIENT * speed * dt);
+            ball.vx *= decay;
+            ball.vy *= decay;
+        }
+
+        // Move in sub-segments, stopping at the exact contact point of each wall hit
+        float remaining = dt;
+        for (int bounce = 0; bounce < MAX_BOUNCES_PER_STEP && remaining > 0.0f; bounce++) {
+            float stepSpeed = sqrtf(ball.vx * ball.vx + ball.vy * ball.vy);
+            float stepDistance = stepSpeed * remaining;
+            if (ball.ignoreWalls || stepDistance <= 0.0f) {
+                ball.x += ball.vx * remaining;
+                ball.y += ball.vy * remaining;
+                break;
+            }
+
+            const float dirX = ball.vx / stepSpeed;
+            const float dirY = ball.vy / stepSpeed;
+            float hitDistance = stepDistance;
+            float normalX = 0.0f;
+            float normalY = 0.0f;
+            bool hit = false;
+            int candidates[MAX_WALL_CANDIDATES];
+            const int found = SweepCandidates(world, ball.x, ball.y, dirX, dirY, stepDistance, ball.radius, candidates);
+            const int wallCount = found < 0 ? static_cast<int>(world.walls.size()) : found;
+            for (int i = 0; i < wallCount; i++) {
+                const OrientedBox& wall = world.walls[found < 0 ? i : candidates[i]];
+                float d, nx, ny;
+                if (SweepCircleOrientedBox(ball.x, ball.y, dirX, dirY, hitDistance, ball.radius, wall, d, nx, ny)) {
+                    hitDistance = d;
+                    normalX = nx;
+                    normalY = ny;
+                    hit = true;
+                }
+            }
+
+            // A screen edge nearer than any wall ends the segment too, so a long
+            // step can't carry the ball off screen and round the end of a wall
+            float edgeDistance, edgeNormalX, edgeNormalY;
+            const bool edge = SweepBoundary(ball, world, dirX, dirY, hitDistance, edgeDistance, edgeNormalX, edgeNormalY);
+            if (edge) {
+                hitDistance = edgeDistance;
+                normalX = edgeNormalX;
+                normalY = edgeNormalY;
+            }
+
+            float travel = stepDistance;
+            if (edge) travel = hitDistance;
+            else if (hit) travel = hitDistance > CONTACT_EPSILON ? hitDistance - CONTACT_EPSILON : 0.0f;
+            ball.x += dirX * travel;
+            ball.y += dirY * travel;
+            if (!hit && !edge) break;
+
+            remaining -= hitDistance / stepSpeed;
+            Reflect(ball, normalX, normalY, edge ? BOUNDARY_BOUNCE_DAMPENING : WALL_BOUNCE_DAMPENING);
+        }
+
+        ResolveBoundary(ball, world);
+
+        if (ball.vx * ball.vx + ball.vy * ball.vy < STOP_SPEED * STOP_SPEED) {
+            Stop(ball);
+        }
+    }
+
+    AdvanceResult AdvanceAnalytic(BallState& ball, const PhysicsWorld& world, float duration, int maxEvents,
+                                  std::vector<PathPoint>* path) {
+        AdvanceResult result = { Event::None, 0, 0, 0, 0.0f };
+        const float k = FRICTION_COEFFICIENT;
+        float remaining = duration;
+
+        while (ball.moving && remaining > 0.0f && result.eventCount < maxEvents) {
+            float speed = sqrtf(ball.vx * ball.vx + ball.vy * ball.vy);
+            if (speed > MAX_VELOCITY) {
+                float scale = MAX_VELOCITY / speed;
+                ball.vx *= scale;
+                ball.vy *= scale;
+                speed = MAX_VELOCITY;
+            }
+            if (speed < STOP_SPEED) {
+                Stop(ball);
+                result.lastEvent = Event::Stopped;
+                result.eventCount++;
+                break;
+            }
+
+            const float dirX = ball.vx / speed;
+            const float dirY = ball.vy / speed;
+
+            // Furthest the ball can roll: until it stops or the time window closes
+            Event event = Event::Stopped;
+            float travel = DistanceToSpeed(speed, STOP_SPEED);
+            float windowDistance = logf(1.0f + k * speed * remaining) / k;
+            if (windowDistance < travel) {
+                travel = windowDistance;
+                event = Event::None;
+            }
+            float normalX = 0.0f;
+            float normalY = 0.0f;
+
+            // Screen boundaries
+            if (SweepBoundary(ball, world, dirX, dirY, travel, travel, normalX, normalY)) {
+                event = Event::Boundary;
+            }
+
+            // Walls
+            if (!ball.ignoreWalls) {
+                int candidates[MAX_WALL_CANDIDATES];
+                const int found = SweepCandidates(world, ball.x, ball.y, dirX, dirY, travel, ball.radius, candidates);
+                const int wallCount = found < 0 ? static_cast<int>(world.walls.size()) : found;
+                for (int i = 0; i < wallCount; i++) {
+                    const OrientedBox& wall = world.walls[found < 0 ? i : candidates[i]];
+                    float d, nx, ny;
+                    if (SweepCircleOrientedBox(ball.x, ball.y, dirX, dirY, travel, ball.radius, wall, d, nx, ny) &&
+                        d < travel) {
+                        travel = d > CONTACT_EPSILON ? d - CONTACT_EPSILON : 0.0f;
+                        event = Event::Wall;
+                        normalX = nx;
+                        normalY = ny;
+                    }
+                }
+            }
+
+            // Hole: the first point inside the cup where the ball is slow enough to drop
+            if (world.hole.enabled) {
+                float px = ball.x - world.hole.x;
+                float py = ball.y - world.hole.y;
+                float b = px * dirX + py * dirY;
+                float c = px * px + py * py - world.hole.radius * world.hole.radius;
+                float disc = b * b - c;
+                if (disc > 0.0f) {
+                    float root = sqrtf(disc);
+                    float enter = -b - root;
+                    float exit = -b + root;
+                    enter = enter > 0.0f ? enter + CONTACT_EPSILON : 0.0f;
+                    float slowEnough = DistanceToSpeed(speed, world.hole.maxEntrySpeed);
+                    float d = enter > slowEnough ? enter : slowEnough;
+                    if (d < exit && d < travel) {
+                        travel = d;
+                        event = Event::Hole;
+                    }
+                }
+            }
+
+            // Jump straight to the event on the closed-form curve
+            const float newSpeed = speed * expf(-k * travel);
+            const float elapsed = (event == Event::None) ? remaining : (expf(k * travel) - 1.0f) / (k * speed);
+            ball.x += dirX * travel;
+            ball.y += dirY * travel;
+            ball.vx = dirX * newSpeed;
+            ball.vy = dirY * newSpeed;
+            remaining -= elapsed;
+            result.elapsed += elapsed;
+
+            if (event == Event::None) break;
+
+            result.lastEvent = event;
+            result.eventCount++;
+
+            if (event == Event::Stopped) {
+                Stop(ball);
+            } else if (event == Event::Wall) {
+                Reflect(ball, normalX, normalY, WALL_BOUNCE_DAMPENING);
+                result.wallHits++;
+                if (path) path->push_back({ ball.x, ball.y });
+            } else if (event == Event::Boundary) {
+                Reflect(ball, normalX, normalY, BOUNDARY_BOUNCE_DAMPENING);
+                ResolveBoundary(ball, world);
+                result.boundaryHits++;
+                if (path) path->push_back({ ball.x, ball.y });
+            } else if (event == Event::Hole) {
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    RestResult SimulateToRest(BallState ball, const PhysicsWorld& world, Integrator integrator,
+                              float fixedStep, float maxTime) {
+        RestResult result = { ball.x, ball.y, false, 0, 0.0f };
+
+        if (integrator == Integrator::Analytic) {
+            while (ball.moving && result.elapsed < maxTime) {
+                // The sweep ignores a wall the ball already overlaps, so push out
+                // first, as the fixed-step path and Level's per-tick pass do
+                if (!ball.ignoreWalls) {
+                    ResolveWallOverlaps(ball, world);
+                }
+                AdvanceResult advance = AdvanceAnalytic(ball, world, maxTime - result.elapsed);
+                result.evaluations += advance.eventCount;
+                result.elapsed += advance.elapsed;
+                if (advance.lastEvent == Event::Hole) {
+                    result.holed = true;
+                    Stop(ball);
+                    break;
+                }
+                if (advance.eventCount == 0) break;
+            }
+        } else {
+            while (ball.moving && result.elapsed < maxTime) {
+                StepFixed(ball, world, fixedStep);
+                if (!ball.ignoreWalls) {
+                    ResolveWallOverlaps(ball, world);
+                }
+                result.evaluations++;
+                result.elapsed += fixedStep;
+
+                if (ball.moving && IsInHole(world.hole, ball.x, ball.y, ball.vx, ball.vy)) {
+                    result.holed = true;
+                    Stop(ball);
+                }
+            }
+        }
+
+        result.x = ball.x;
+        result.y = ball.y;
+        return result;
+    }
+
+    bool ResolveBoundary(BallState& ball, const PhysicsWorld& world) {
+        bool hit = false;
+        if (ball.x < ball.radius) {
+            ball.x = ball.radius;
+            ball.vx = fabsf(ball.vx) * BOUNDARY_BOUNCE_DAMPENING;
+            hit = true;
+        }
+        if (ball.x > world.width - ball.radius) {
+            ball.x = world.width - ball.radius;
+            ball.vx = -fabsf(ball.vx) * BOUNDARY_BOUNCE_DAMPENING;
+            hit = true;
+        }
+        if (ball.y < ball.radius) {
+            ball.y = ball.radius;
+            ball.vy = fabsf(ball.vy) * BOUNDARY_BOUNCE_DAMPENING;
+            hit = true;
+        }
+        if (ball.y > world.height - ball.radius) {
+            ball.y = world.height - ball.radius;
+            ball.vy = -fabsf(ball.vy) * BOUNDARY_BOUNCE_DAMPENING;
+            hit = true;
+        }
+        if (hit) ball.moving = true;
+        return hit;
+    }
+
+    bool ResolveWallOverlap(BallState& ball, const WallBox& wall) {
+        // Closest point on the wall to the ball's centre
+        float closestX = ball.x < wall.left ? wall.left : (ball.x > wall.right ? wall.right : ball.x);
+        float closestY = ball.y < wall.top ? wall.top : (ball.y > wall.bottom ? wall.bottom : ball.y);
+        float dx = ball.x - closestX;
+        float dy = ball.y - closestY;
+        float distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared >= ball.radius * ball.radius) return false;
+
+        float normalX = 0.0f;
+        float normalY = 0.0f;
+        float depth = 0.0f;
+        if (distanceSquared > 1e-8f) {
+            float distance = sqrtf(distanceSquared);
+            normalX = dx / distance;
+            normalY = dy / distance;
+            depth = ball.radius - distance;
+        } else {
+            // Centre is inside the wall: push out through the nearest face
+            float leftPen = ball.x - wall.left;
+            float rightPen = wall.right - ball.x;
+            float topPen = ball.y - wall.top;
+            float bottomPen = wall.bottom - ball.y;
+            depth = leftPen; normalX = -1.0f;
+            if (rightPen < depth) { depth = rightPen; normalX = 1.0f; }
+            if (topPen < depth) { depth = topPen; normalX = 0.0f; normalY = -1.0f; }
+            if (bottomPen < depth) { depth = bottomPen; normalX = 0.0f; normalY = 1.0f; }
+            depth += ball.radius;
+        }
+
+        // Move ball out of wall and bounce off the contact normal
+        ball.x += normalX * (depth + CONTACT_EPSILON);
+        ball.y += normalY * (depth + CONTACT_EPSILON);
+        Reflect(ball, normalX, normalY, WALL_BOUNCE_DAMPENING);
+        ball.moving = true;
+        return true;
+    }
+
+    bool ResolveWallOverlap(BallState& ball, const OrientedBox& wall) {
+        if (IsAxisAligned(wall)) {
+            return ResolveWallOverlap(ball, GetBoundingBox(wall));
+        }
+
+        const WallBox local = { -wall.halfWidth, -wall.halfHeight, wall.halfWidth, wall.halfHeight };
+        BallState localBall = ball;
+        ToBoxFrame(wall, localBall);
+        if (!ResolveWallOverlap(localBall, local)) return false;
+
+        FromBoxFrame(wall, localBall);
+        ball = localBall;
+        return true;
+    }
+
+    void ResolveWallOverlaps(BallState& ball, const PhysicsWorld& world) {
+        // Each push-out moves the ball, so after resolving a wall the later ones
+        // are looked up again from the new position. The lookup radius has a
+        // little slack; ResolveWallOverlap makes the exact call.
+        const int wallCount = static_cast<int>(world.walls.size());
+        int first = 0;
+        while (first < wallCount) {
+            int overlaps[MAX_WALL_CANDIDATES];
+            int found = FindWallOverlaps(world.wallLanes, ball.x, ball.y, ball.radius + CONTACT_EPSILON,
+                                         overlaps, MAX_WALL_CANDIDATES);
+            if (found > MAX_WALL_CANDIDATES) {
+                for (int i = first; i < wallCount; i++) {
+                    ResolveWallOverlap(ball, world.walls[i]);
+                }
+                return;
+            }
+
+            int next = -1;
+            for (int i = 0; i < found; i++) {
+                if (overlaps[i] >= first) { next = overlaps[i]; break; }
+            }
+            if (next < 0) return;
+
+            ResolveWallOverlap(ball, world.walls[next]);
+            first = next + 1;
+        }
+    }
+
+    bool IsInHole(const HoleTarget& hole, float x, float y, float vx, float vy) {
+        if (!hole.enabled) return false;
+
+        float dx = x - hole.x;
+        float dy = y - hole.y;
+        if (dx * dx + dy * dy >= hole.radius * hole.radius) return false;
+
+        // Only allow entry if the ball is slow enough to drop
+        return sqrtf(vx * vx + vy * vy) <= hole.maxEntrySpeed;
+    }
+}
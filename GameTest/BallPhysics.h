@@ -0,0 +1,177 @@
+#pragma once
+#include <vector>
+
+// Headless ball motion model shared by Ball and anything that needs to
+// predict where a shot goes. Distances are pixels, time is seconds.
+//
+// Between contacts the ball obeys dv/dt = -k|v|v, which has a closed form:
+//   speed(t)    = s0 / (1 + k*s0*t)
+//   distance(t) = ln(1 + k*s0*t) / k
+// so the analytic integrator can jump straight to the next event instead of
+// taking small Euler steps.
+namespace BallPhysics {
+
+    constexpr float FRICTION_COEFFICIENT = 0.075f * 0.05f;  // k, per pixel
+    constexpr float STOP_SPEED = 100.0f;
+    constexpr float MAX_VELOCITY = 25000.0f;
+    constexpr float WALL_BOUNCE_DAMPENING = 0.8f;
+    constexpr float BOUNDARY_BOUNCE_DAMPENING = 0.95f;
+    constexpr float ENEMY_BOUNCE_SPEED = 500.0f;
+    constexpr float LAUNCH_SPEED = 2000.0f;      // At full drag
+    constexpr float MAX_DRAG_LENGTH = 100.0f;
+    constexpr float BALL_RESTITUTION = 0.8f;
+    constexpr float MAX_COLLISION_VELOCITY = 15000.0f;
+    constexpr int WALL_LANES = 4;                // Walls per FindWallOverlaps iteration
+
+    enum class Integrator {
+        FixedStep,  // Euler reference, matches the original Ball::Update
+        Analytic    // Event-driven, closed-form between contacts
+    };
+
+    enum class Event {
+        None,
+        Stopped,
+        Wall,
+        Boundary,
+        Hole
+    };
+
+    struct BallState {
+        float x, y;
+        float vx, vy;
+        float radius;
+        bool moving;
+        bool ignoreWalls;  // Phase mode
+    };
+
+    // What a ball-vs-ball contact needs; mass only matters relative to the other ball
+    struct BallBody {
+        float x, y;
+        float vx, vy;
+        float radius;
+        float mass;
+    };
+
+    struct PathPoint {
+        float x, y;
+    };
+
+    struct WallBox {
+        float left, top, right, bottom;
+    };
+
+    // A wall rotated about its centre. Axis-aligned walls (including quarter
+    // turns) have cos exactly 1 and sin exactly 0, and take the WallBox paths.
+    struct OrientedBox {
+        float centerX, centerY;
+        float halfWidth, halfHeight;
+        float cosAngle, sinAngle;
+    };
+
+    // The same walls as parallel arrays padded to WALL_LANES, so the circle test
+    // runs on a whole group at once. Padding lanes sit far off screen.
+    struct WallLanes {
+        std::vector<float> centerX, centerY;
+        std::vector<float> halfWidth, halfHeight;
+        std::vector<float> cosAngle, sinAngle;
+        int count = 0;
+
+        void Add(const OrientedBox& box);
+        // Moves the last lane into `index`; order is not kept
+        void RemoveSwap(int index);
+        void Clear();
+    };
+
+    struct HoleTarget {
+        float x, y;
+        float radius;
+        float maxEntrySpeed;
+        bool enabled;
+    };
+
+    // Static geometry the ball can hit. Owned by Level, rebuilt when walls change.
+    struct PhysicsWorld {
+        float width = 0.0f;
+        float height = 0.0f;
+        std::vector<OrientedBox> walls;   // Change through AddWall/ClearWalls so wallLanes keeps up
+        WallLanes wallLanes;
+        HoleTarget hole = { 0.0f, 0.0f, 0.0f, 0.0f, false };
+
+        void AddWall(const OrientedBox& wall) { walls.push_back(wall); wallLanes.Add(wall); }
+        // The last wall takes `index`'s place
+        void RemoveWall(int index) { walls[index] = walls.back(); walls.pop_back(); wallLanes.RemoveSwap(index); }
+        void ClearWalls() { walls.clear(); wallLanes.Clear(); }
+    };
+
+    struct AdvanceResult {
+        Event lastEvent;
+        int eventCount;
+        int wallHits;
+        int boundaryHits;
+        float elapsed;
+    };
+
+    struct RestResult {
+        float x, y;
+        bool holed;
+        int evaluations;   // Euler steps or analytic events, whichever path ran
+        float elapsed;
+    };
+
+    // One Euler step of friction, velocity cap and boundary bounces. The step's
+    // displacement is swept against the walls so fast shots can't tunnel.
+    void StepFixed(BallState& ball, const PhysicsWorld& world, float dt);
+
+    // Advances along the closed-form curve for up to `duration` seconds,
+    // resolving every stop/wall/boundary/hole event that falls inside it.
+    // On a Hole event the ball is left just inside the cup, still moving,
+    // so the caller's hole check sees it.
+    // When `path` is given, the contact point of every bounce is appended to it.
+    AdvanceResult AdvanceAnalytic(BallState& ball, const PhysicsWorld& world, float duration, int maxEvents = 64,
+                                  std::vector<PathPoint>* path = nullptr);
+
+    // Runs a shot until it rests or drops, using either integrator.
+    RestResult SimulateToRest(BallState ball, const PhysicsWorld& world, Integrator integrator,
+                              float fixedStep = 1.0f / 120.0f, float maxTime = 30.0f);
+
+    // Builds a wall box from its centre, full size and rotation in degrees.
+    OrientedBox MakeOrientedBox(float centerX, float centerY, float width, float height, float rotationDegrees);
+    bool IsAxisAligned(const OrientedBox& box);
+    WallBox GetBoundingBox(const OrientedBox& box);
+
+    // Circle-vs-oriented-box narrow phase: the circle centre is rotated into each
+    // box's frame and its distance to the box compared with the radius, which is
+    // the separating-axis test for this pair. Runs WALL_LANES walls per iteration
+    // (SSE where the compiler targets it). Writes the indices of up to maxOut
+    // overlapping walls in ascending order and returns how many overlap in total,
+    // so a result above maxOut means `out` was truncated.
+    int FindWallOverlaps(const WallLanes& walls, float x, float y, float radius, int* out, int maxOut);
+    bool CircleOverlapsBox(const OrientedBox& box, float x, float y, float radius);
+
+    // Time of impact of a circle moving along unit (dirX, dirY) against a wall.
+    // Returns the travel distance to first contact within maxDistance and the
+    // contact normal; a circle that already overlaps the wall never hits.
+    bool SweepCircleBox(float ox, float oy, float dirX, float dirY, float maxDistance, float radius,
+                        const WallBox& wall, float& distance, float& normalX, float& normalY);
+    bool SweepCircleOrientedBox(float ox, float oy, float dirX, float dirY, float maxDistance, float radius,
+                                const OrientedBox& wall, float& distance, float& normalX, float& normalY);
+
+    // Overlap fixes: circle-vs-box push-out along the contact normal. Used as a
+    // safety net after each step (Ball::HandleWallCollision) by both integrators.
+    bool ResolveBoundary(BallState& ball, const PhysicsWorld& world);
+    bool ResolveWallOverlap(BallState& ball, const WallBox& wall);
+    bool ResolveWallOverlap(BallState& ball, const OrientedBox& wall);
+
+    // ResolveWallOverlap against every wall the ball can touch, in wall order.
+    void ResolveWallOverlaps(BallState& ball, const PhysicsWorld& world);
+    bool IsInHole(const HoleTarget& hole, float x, float y, float vx, float vy);
+
+    void Stop(BallState& ball);
+
+    // Restitution impulse and half-and-half overlap push-out between two
+    // overlapping balls. Returns false if they don't touch or already separate.
+    bool ResolveBallContact(BallBody& a, BallBody& b);
+
+    // Launch velocity for a shot of `power` (drag length) along `angle`.
+    void LaunchVelocity(float power, float angle, float speedMultiplier, float& vx, float& vy);
+}
@@ -0,0 +1,209 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "BallPhysics.h"
+#include "Level.h"
+#include "LevelGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+    const float SHOT_MAX_POWER = 100.0f;
+
+    // The fixed-step path is Euler with the exact per-step friction decay, so
+    // it trails the closed form by O(step). A fine step should land on it.
+    const float FINE_STEP = 1.0f / 960.0f;
+
+    BallPhysics::BallState MakeShot(float x, float y, float power, float angle) {
+        BallPhysics::BallState ball = { x, y, 0.0f, 0.0f, 10.0f, true, false };
+        BallPhysics::LaunchVelocity(power, angle, 1.0f, ball.vx, ball.vy);
+        return ball;
+    }
+
+    struct Comparison {
+        int shots = 0;
+        int holedMismatches = 0;
+        double totalDistance = 0.0;
+        float maxDistance = 0.0f;
+        std::vector<float> distances;
+
+        void Add(const BallPhysics::RestResult& analytic, const BallPhysics::RestResult& fixed) {
+            shots++;
+            if (analytic.holed != fixed.holed) holedMismatches++;
+            if (analytic.holed || fixed.holed) return;
+            const float distance = hypotf(analytic.x - fixed.x, analytic.y - fixed.y);
+            totalDistance += distance;
+            maxDistance = std::max(maxDistance, distance);
+            distances.push_back(distance);
+        }
+
+        double Mean() const { return distances.empty() ? 0.0 : totalDistance / distances.size(); }
+        float Percentile(float fraction) {
+            if (distances.empty()) return 0.0f;
+            const size_t index = std::min(distances.size() - 1, static_cast<size_t>(distances.size() * fraction));
+            std::nth_element(distances.begin(), distances.begin() + index, distances.end());
+            return distances[index];
+        }
+    };
+}
+
+// Away from walls and edges both integrators follow the same curve
+SELFTEST_CASE(BallPhysics_AnalyticMatchesFixedStepInOpenField) {
+    BallPhysics::PhysicsWorld world;
+    world.width = 4000.0f;
+    world.height = 4000.0f;
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> power(5.0f, SHOT_MAX_POWER);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    Comparison gameStep, fineStep;
+    float maxClosedFormError = 0.0f;
+    for (int i = 0; i < 500; i++) {
+        const BallPhysics::BallState shot = MakeShot(2000.0f, 2000.0f, power(rng), angle(rng));
+        const BallPhysics::RestResult analytic = BallPhysics::SimulateToRest(shot, world, BallPhysics::Integrator::Analytic);
+        gameStep.Add(analytic, BallPhysics::SimulateToRest(shot, world, BallPhysics::Integrator::FixedStep));
+        fineStep.Add(analytic, BallPhysics::SimulateToRest(shot, world, BallPhysics::Integrator::FixedStep, FINE_STEP));
+
+        // Rolls until speed falls to STOP_SPEED: distance = ln(s0 / STOP_SPEED) / k
+        const float speed = hypotf(shot.vx, shot.vy);
+        if (speed > BallPhysics::STOP_SPEED) {
+            const float expected = logf(speed / BallPhysics::STOP_SPEED) / BallPhysics::FRICTION_COEFFICIENT;
+            const float travelled = hypotf(analytic.x - shot.x, analytic.y - shot.y);
+            maxClosedFormError = std::max(maxClosedFormError, fabsf(travelled - expected));
+        }
+    }
+
+    context.Log("%d shots vs the game step: mean %.2fpx, max %.2fpx; vs 1/960s: mean %.2fpx, max %.2fpx",
+                gameStep.shots, gameStep.Mean(), gameStep.maxDistance, fineStep.Mean(), fineStep.maxDistance);
+    context.Log("analytic vs closed form: max %.3fpx", maxClosedFormError);
+    SELFTEST_CHECK(context, gameStep.maxDistance < 10.0f);
+    SELFTEST_CHECK(context, fineStep.maxDistance < 1.5f);
+    SELFTEST_CHECK(context, maxClosedFormError < 0.5f);
+}
+
+// Shots from each generated course's tee. A graze of a wall corner can send
+// the two paths apart however fine the step, so a few far outliers are allowed.
+SELFTEST_CASE(BallPhysics_AnalyticMatchesFixedStepOnCourses) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> power(5.0f, SHOT_MAX_POWER);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    Comparison gameStep, fineStep;
+    int outliers = 0;
+    LevelGenerator generator(11u);
+    for (int levelNumber = 0; levelNumber < 10; levelNumber++) {
+        std::unique_ptr<Level> level = generator.GenerateLevel(levelNumber, 100u + levelNumber);
+        if (!SELFTEST_CHECK(context, level && level->GetBall())) return;
+
+        const BallPhysics::PhysicsWorld& world = level->GetPhysicsWorld();
+        float startX, startY;
+        level->GetBall()->GetPosition(startX, startY);
+        for (int i = 0; i < 200; i++) {
+            const BallPhysics::BallState shot = MakeShot(startX, startY, power(rng), angle(rng));
+            const BallPhysics::RestResult analytic = BallPhysics::SimulateToRest(shot, world, BallPhysics::Integrator::Analytic);
+            const BallPhysics::RestResult fine = BallPhysics::SimulateToRest(shot, world, BallPhysics::Integrator::FixedStep, FINE_STEP);
+            gameStep.Add(analytic, BallPhysics::SimulateToRest(shot, world, BallPhysics::Integrator::FixedStep));
+            fineStep.Add(analytic, fine);
+            if (!analytic.holed && !fine.holed && hypotf(analytic.x - fine.x, analytic.y - fine.y) > 20.0f) outliers++;
+        }
+    }
+
+    context.Log("%d shots vs the game step: %d holed mismatches, mean %.2fpx, median %.2fpx, p90 %.2fpx",
+                gameStep.shots, gameStep.holedMismatches, gameStep.Mean(), gameStep.Percentile(0.5f), gameStep.Percentile(0.9f));
+    const float median = fineStep.Percentile(0.5f);
+    const float p90 = fineStep.Percentile(0.9f);
+    context.Log("vs 1/960s: %d holed mismatches, mean %.2fpx, median %.2fpx, p90 %.2fpx, %d over 20px (max %.1fpx)",
+                fineStep.holedMismatches, fineStep.Mean(), median, p90, outliers, fineStep.maxDistance);
+    SELFTEST_CHECK(context, gameStep.holedMismatches <= gameStep.shots / 100);
+    SELFTEST_CHECK(context, fineStep.holedMismatches <= fineStep.shots / 100);
+    SELFTEST_CHECK(context, median < 1.0f);
+    SELFTEST_CHECK(context, p90 < 2.0f);
+    SELFTEST_CHECK(context, outliers <= fineStep.shots / 200);
+}
+
+// Max-power and max-velocity shots at a wall spanning the screen, at
+// thicknesses either side of one step's travel, with both integrators
+// stepped the way Level::Update steps them. Any ball centre found past the
+// wall's middle is a tunnel.
+SELFTEST_CASE(BallPhysics_FastShotsNeverTunnel) {
+    const float WALL_X = 600.0f;
+    const float thicknesses[] = { 2.0f, 20.0f };
+    const float steps[] = { 1.0f / 240.0f, 1.0f / 120.0f, 1.0f / 60.0f, 1.0f / 30.0f };
+    const BallPhysics::Integrator integrators[] = { BallPhysics::Integrator::FixedStep, BallPhysics::Integrator::Analytic };
+    const int SHOTS = 500;
+    const float MAX_SHOT_SECONDS = 4.0f;
+
+    int shots = 0;
+    long long wallHits = 0;
+    for (float thickness : thicknesses) {
+        BallPhysics::PhysicsWorld world;
+        world.width = 1024.0f;
+        world.height = 768.0f;
+        world.AddWall(BallPhysics::MakeOrientedBox(WALL_X, world.height * 0.5f, thickness, world.height, 0.0f));
+
+        for (BallPhysics::Integrator integrator : integrators) {
+            for (float step : steps) {
+                std::mt19937 rng(4);
+                std::uniform_real_distribution<float> startX(50.0f, WALL_X - thickness * 0.5f - 20.0f);
+                std::uniform_real_distribution<float> startY(50.0f, world.height - 50.0f);
+                std::uniform_real_distribution<float> angle(-1.2f, 1.2f);
+
+                int tunnels = 0;
+                for (int i = 0; i < SHOTS; i++) {
+                    // Half at full drag with a double speed boost, half at the velocity cap
+                    BallPhysics::BallState ball = MakeShot(startX(rng), startY(rng), SHOT_MAX_POWER, angle(rng));
+                    const float boost = i % 2 == 0 ? 2.0f : BallPhysics::MAX_VELOCITY / BallPhysics::LAUNCH_SPEED;
+                    ball.vx *= boost;
+                    ball.vy *= boost;
+                    shots++;
+
+                    for (float elapsed = 0.0f; ball.moving && elapsed < MAX_SHOT_SECONDS; elapsed += step) {
+                        if (integrator == BallPhysics::Integrator::Analytic) {
+                            wallHits += BallPhysics::AdvanceAnalytic(ball, world, step).wallHits;
+                        } else {
+                            const float before = ball.vx;
+                            BallPhysics::StepFixed(ball, world, step);
+                            if (before > 0.0f && ball.vx <= 0.0f) wallHits++;
+                        }
+                        BallPhysics::ResolveWallOverlaps(ball, world);
+                        if (ball.x > WALL_X) {
+                            tunnels++;
+                            break;
+                        }
+                    }
+                }
+                if (!SELFTEST_CHECK(context, tunnels == 0)) {
+                    context.Log("%s, %.0fpx wall, 1/%.0fs step: %d of %d shots tunnelled",
+                                integrator == BallPhysics::Integrator::Analytic ? "analytic" : "fixed step",
+                                thickness, 1.0f / step, tunnels, SHOTS);
+                }
+            }
+        }
+    }
+    context.Log("%d shots, %lld wall hits", shots, wallHits);
+}
+
+// RemoveWall swaps lanes around in place; the lanes must come out the same as
+// building them again from the walls left, padding included
+SELFTEST_CASE(BallPhysics_RemoveWallKeepsLanesInStep) {
+    BallPhysics::PhysicsWorld world;
+    for (int i = 0; i < 9; i++) {
+        world.AddWall(BallPhysics::MakeOrientedBox(100.0f + 80.0f * i, 300.0f, 60.0f, 20.0f, 15.0f * i));
+    }
+
+    const int removals[] = { 1, 7, 0, 3, 4 };
+    for (int index : removals) {
+        world.RemoveWall(index);
+
+        BallPhysics::PhysicsWorld rebuilt;
+        for (const BallPhysics::OrientedBox& wall : world.walls) rebuilt.AddWall(wall);
+        const BallPhysics::WallLanes& a = world.wallLanes;
+        const BallPhysics::WallLanes& b = rebuilt.wallLanes;
+        SELFTEST_CHECK(context, a.count == b.count && a.centerX == b.centerX && a.centerY == b.centerY &&
+                                a.halfWidth == b.halfWidth && a.halfHeight == b.halfHeight &&
+                                a.cosAngle == b.cosAngle && a.sinAngle == b.sinAngle);
+    }
+    SELFTEST_CHECK(context, world.walls.size() == 4 && world.wallLanes.centerX.size() == 4);
+}
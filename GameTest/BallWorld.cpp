@@ -0,0 +1,232 @@
+#include "stdafx.h"
+#include "BallWorld.h"
+#include <cmath>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+BallWorld::BallWorld(float width, float height) : m_width(width), m_height(height) {
+}
+
+int BallWorld::AddBall(float x, float y, float radius, float speedMultiplier, float mass) {
+    int index = m_count++;
+    if (index % LANES == 0) {
+        // Open a new block of lanes, all padding until filled
+        size_t size = m_posX.size() + LANES;
+        m_posX.resize(size, 0.0f);
+        m_posY.resize(size, 0.0f);
+        m_velX.resize(size, 0.0f);
+        m_velY.resize(size, 0.0f);
+        m_radius.resize(size, 0.0f);
+        m_mass.resize(size, 1.0f);
+        m_speedMultiplier.resize(size, 1.0f);
+        m_moving.resize(size, 0.0f);
+    }
+
+    m_posX[index] = x;
+    m_posY[index] = y;
+    m_radius[index] = radius;
+    m_mass[index] = mass;
+    m_speedMultiplier[index] = speedMultiplier;
+    m_maxRadius = std::max(m_maxRadius, radius);
+    return index;
+}
+
+void BallWorld::Clear() {
+    m_count = 0;
+    m_maxRadius = 0.0f;
+    m_posX.clear();
+    m_posY.clear();
+    m_velX.clear();
+    m_velY.clear();
+    m_radius.clear();
+    m_mass.clear();
+    m_speedMultiplier.clear();
+    m_moving.clear();
+}
+
+void BallWorld::Launch(int index, float power, float angle) {
+    BallPhysics::LaunchVelocity(power, angle, m_speedMultiplier[index], m_velX[index], m_velY[index]);
+    m_moving[index] = 1.0f;
+}
+
+void BallWorld::SetVelocity(int index, float vx, float vy) {
+    m_velX[index] = vx;
+    m_velY[index] = vy;
+    m_moving[index] = 1.0f;
+}
+
+void BallWorld::Step(float dt) {
+    for (int first = 0; first < m_count; first += LANES) {
+        IntegrateLanes(first, dt);
+    }
+    ResolveContacts();
+}
+
+#if defined(__AVX__)
+
+void BallWorld::IntegrateLanes(int first, float dt) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 maxVelocity = _mm256_set1_ps(BallPhysics::MAX_VELOCITY);
+    const __m256 friction = _mm256_set1_ps(BallPhysics::FRICTION_COEFFICIENT * dt);
+    const __m256 bounce = _mm256_set1_ps(BallPhysics::BOUNDARY_BOUNCE_DAMPENING);
+    const __m256 stopSpeedSquared = _mm256_set1_ps(BallPhysics::STOP_SPEED * BallPhysics::STOP_SPEED);
+    const __m256 width = _mm256_set1_ps(m_width);
+    const __m256 height = _mm256_set1_ps(m_height);
+
+    __m256 x = _mm256_loadu_ps(&m_posX[first]);
+    __m256 y = _mm256_loadu_ps(&m_posY[first]);
+    __m256 vx = _mm256_loadu_ps(&m_velX[first]);
+    __m256 vy = _mm256_loadu_ps(&m_velY[first]);
+    __m256 r = _mm256_loadu_ps(&m_radius[first]);
+    __m256 moving = _mm256_loadu_ps(&m_moving[first]);
+    __m256 movingMask = _mm256_cmp_ps(moving, zero, _CMP_NEQ_OQ);
+
+    // Velocity cap, then exact per-step friction decay (see BallPhysics::StepFixed)
+    __m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+    __m256 cap = _mm256_min_ps(one, _mm256_div_ps(maxVelocity, _mm256_max_ps(speed, one)));
+    speed = _mm256_mul_ps(speed, cap);
+    __m256 scale = _mm256_div_ps(cap, _mm256_add_ps(one, _mm256_mul_ps(friction, speed)));
+    vx = _mm256_mul_ps(vx, scale);
+    vy = _mm256_mul_ps(vy, scale);
+
+    x = _mm256_add_ps(x, _mm256_mul_ps(vx, vdt));
+    y = _mm256_add_ps(y, _mm256_mul_ps(vy, vdt));
+
+    // Boundary bounces
+    __m256 absVx = _mm256_mul_ps(_mm256_andnot_ps(signMask, vx), bounce);
+    __m256 absVy = _mm256_mul_ps(_mm256_andnot_ps(signMask, vy), bounce);
+    __m256 right = _mm256_sub_ps(width, r);
+    __m256 bottom = _mm256_sub_ps(height, r);
+
+    __m256 hit = _mm256_cmp_ps(x, r, _CMP_LT_OQ);
+    x = _mm256_blendv_ps(x, r, hit);
+    vx = _mm256_blendv_ps(vx, absVx, hit);
+    hit = _mm256_cmp_ps(x, right, _CMP_GT_OQ);
+    x = _mm256_blendv_ps(x, right, hit);
+    vx = _mm256_blendv_ps(vx, _mm256_xor_ps(absVx, signMask), hit);
+    hit = _mm256_cmp_ps(y, r, _CMP_LT_OQ);
+    y = _mm256_blendv_ps(y, r, hit);
+    vy = _mm256_blendv_ps(vy, absVy, hit);
+    hit = _mm256_cmp_ps(y, bottom, _CMP_GT_OQ);
+    y = _mm256_blendv_ps(y, bottom, hit);
+    vy = _mm256_blendv_ps(vy, _mm256_xor_ps(absVy, signMask), hit);
+
+    // Stop slow balls
+    __m256 speedSquared = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+    __m256 keep = _mm256_and_ps(movingMask, _mm256_cmp_ps(speedSquared, stopSpeedSquared, _CMP_GE_OQ));
+    vx = _mm256_and_ps(vx, keep);
+    vy = _mm256_and_ps(vy, keep);
+
+    // Resting lanes keep their position untouched
+    _mm256_storeu_ps(&m_posX[first], _mm256_blendv_ps(_mm256_loadu_ps(&m_posX[first]), x, movingMask));
+    _mm256_storeu_ps(&m_posY[first], _mm256_blendv_ps(_mm256_loadu_ps(&m_posY[first]), y, movingMask));
+    _mm256_storeu_ps(&m_velX[first], vx);
+    _mm256_storeu_ps(&m_velY[first], vy);
+    _mm256_storeu_ps(&m_moving[first], _mm256_and_ps(keep, one));
+}
+
+#else
+
+// Same math as the AVX path as a fixed 8-wide loop of selects, which the
+// compiler can vectorise for whatever SIMD width it targets.
+void BallWorld::IntegrateLanes(int first, float dt) {
+    const float friction = BallPhysics::FRICTION_COEFFICIENT * dt;
+    const float stopSpeedSquared = BallPhysics::STOP_SPEED * BallPhysics::STOP_SPEED;
+
+    float* x = &m_posX[first];
+    float* y = &m_posY[first];
+    float* vx = &m_velX[first];
+    float* vy = &m_velY[first];
+    const float* r = &m_radius[first];
+    float* moving = &m_moving[first];
+
+    for (int lane = 0; lane < LANES; lane++) {
+        float speed = sqrtf(vx[lane] * vx[lane] + vy[lane] * vy[lane]);
+        float cap = std::min(1.0f, BallPhysics::MAX_VELOCITY / std::max(speed, 1.0f));
+        float scale = cap / (1.0f + friction * speed * cap);
+        float lvx = vx[lane] * scale;
+        float lvy = vy[lane] * scale;
+
+        float lx = x[lane] + lvx * dt;
+        float ly = y[lane] + lvy * dt;
+
+        float absVx = fabsf(lvx) * BallPhysics::BOUNDARY_BOUNCE_DAMPENING;
+        float absVy = fabsf(lvy) * BallPhysics::BOUNDARY_BOUNCE_DAMPENING;
+        float right = m_width - r[lane];
+        float bottom = m_height - r[lane];
+        if (lx < r[lane]) { lx = r[lane]; lvx = absVx; }
+        if (lx > right) { lx = right; lvx = -absVx; }
+        if (ly < r[lane]) { ly = r[lane]; lvy = absVy; }
+        if (ly > bottom) { ly = bottom; lvy = -absVy; }
+
+        float keep = (moving[lane] != 0.0f && lvx * lvx + lvy * lvy >= stopSpeedSquared) ? 1.0f : 0.0f;
+        if (moving[lane] != 0.0f) {
+            x[lane] = lx;
+            y[lane] = ly;
+        }
+        vx[lane] = lvx * keep;
+        vy[lane] = lvy * keep;
+        moving[lane] = keep;
+    }
+}
+
+#endif
+
+void BallWorld::ResolveContacts() {
+    m_candidatePairs = 0;
+    m_contacts = 0;
+
+    // Only moving balls search for contacts; a resting pair stays where it settled
+    m_awake.clear();
+    for (int i = 0; i < m_count; i++) {
+        if (m_moving[i] != 0.0f) m_awake.push_back(i);
+    }
+    m_movingCount = static_cast<int>(m_awake.size());
+    if (m_awake.empty()) return;
+
+    // Balls are binned by centre, so a cell no smaller than the widest
+    // contact distance keeps every candidate within the 3x3 neighbourhood
+    float cellSize = std::max(2.0f * m_maxRadius, 16.0f);
+    if (m_grid.GetCellSize() != cellSize || m_grid.GetColumns() == 0) {
+        m_grid.Reset(m_width, m_height, cellSize);
+    }
+    m_grid.ClearDynamic();
+    for (int i = 0; i < m_count; i++) {
+        m_grid.InsertDynamic(i, m_posX[i], m_posY[i], m_posX[i], m_posY[i]);
+    }
+
+    m_wasAwake.assign(m_count, 0);
+    for (int i : m_awake) m_wasAwake[i] = 1;
+
+    for (int i : m_awake) {
+        float reach = m_radius[i] + m_maxRadius;
+        m_candidates.clear();
+        m_grid.Query(m_posX[i] - reach, m_posY[i] - reach, m_posX[i] + reach, m_posY[i] + reach, m_candidates);
+
+        for (int j : m_candidates) {
+            // Pairs of two awake balls are handled once, from the lower index
+            if (j == i || (m_wasAwake[j] && j < i)) continue;
+            m_candidatePairs++;
+
+            BallPhysics::BallBody a = { m_posX[i], m_posY[i], m_velX[i], m_velY[i], m_radius[i], m_mass[i] };
+            BallPhysics::BallBody b = { m_posX[j], m_posY[j], m_velX[j], m_velY[j], m_radius[j], m_mass[j] };
+            if (!BallPhysics::ResolveBallContact(a, b)) continue;
+
+            m_posX[i] = a.x;
+            m_posY[i] = a.y;
+            m_velX[i] = a.vx;
+            m_velY[i] = a.vy;
+            m_posX[j] = b.x;
+            m_posY[j] = b.y;
+            m_velX[j] = b.vx;
+            m_velY[j] = b.vy;
+            m_moving[i] = 1.0f;
+            m_moving[j] = 1.0f;
+            m_contacts++;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include "BallPhysics.h"
+#include "SpatialGrid.h"
+
+// Many balls on an open field, stored as parallel arrays so friction, the
+// velocity cap and boundary bounces run 8 balls at a time (AVX when the
+// compiler targets it, a fixed 8-wide loop otherwise). Ball-ball contacts are
+// found through a SpatialGrid and resolved with BallPhysics::ResolveBallContact.
+//
+// Walls are not handled here; single balls in a level still go through Ball.
+class BallWorld {
+public:
+    static constexpr int LANES = 8;
+
+    BallWorld(float width, float height);
+
+    int AddBall(float x, float y, float radius, float speedMultiplier = 1.0f, float mass = 1.0f);
+    void Clear();
+
+    void Launch(int index, float power, float angle);
+    void SetVelocity(int index, float vx, float vy);
+
+    // One fixed step: integrate every lane, then resolve contacts.
+    void Step(float dt);
+
+    int GetCount() const { return m_count; }
+    float GetX(int index) const { return m_posX[index]; }
+    float GetY(int index) const { return m_posY[index]; }
+    float GetVelocityX(int index) const { return m_velX[index]; }
+    float GetVelocityY(int index) const { return m_velY[index]; }
+    float GetRadius(int index) const { return m_radius[index]; }
+    bool IsMoving(int index) const { return m_moving[index] != 0.0f; }
+
+    // Last Step() stats
+    int GetMovingCount() const { return m_movingCount; }
+    int GetCandidatePairs() const { return m_candidatePairs; }
+    int GetContacts() const { return m_contacts; }
+
+private:
+    void IntegrateLanes(int first, float dt);
+    void ResolveContacts();
+
+    float m_width;
+    float m_height;
+    int m_count = 0;
+    float m_maxRadius = 0.0f;
+
+    // Padded to a multiple of LANES; padding lanes have zero radius and never move
+    std::vector<float> m_posX, m_posY;
+    std::vector<float> m_velX, m_velY;
+    std::vector<float> m_radius;
+    std::vector<float> m_mass;
+    std::vector<float> m_speedMultiplier;
+    std::vector<float> m_moving;   // 1.0f or 0.0f so it can be used as a lane mask
+
+    SpatialGrid m_grid;
+    std::vector<int> m_candidates;
+    std::vector<int> m_awake;               // Moving at the start of the contact pass
+    std::vector<unsigned char> m_wasAwake;
+
+    int m_movingCount = 0;
+    int m_candidatePairs = 0;
+    int m_contacts = 0;
+};
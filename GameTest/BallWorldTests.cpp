@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "BallWorld.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// Away from edges and other balls a lane must follow BallPhysics::StepFixed
+SELFTEST_CASE(BallWorld_SingleBallMatchesStepFixed) {
+    const float STEP = 1.0f / 120.0f;
+    // A full-power shot rolls about 800px, so it never reaches an edge from the middle
+    BallWorld world(2048.0f, 2048.0f);
+    BallPhysics::PhysicsWorld reference;
+    reference.width = 2048.0f;
+    reference.height = 2048.0f;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> power(5.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    float maxError = 0.0f;
+    int stopMismatches = 0;
+    for (int shot = 0; shot < 100; shot++) {
+        world.Clear();
+        const int index = world.AddBall(1024.0f, 1024.0f, 10.0f);
+        world.Launch(index, power(rng), angle(rng));
+
+        BallPhysics::BallState ball = { 1024.0f, 1024.0f, world.GetVelocityX(index), world.GetVelocityY(index),
+                                        10.0f, true, false };
+        while (ball.moving || world.IsMoving(index)) {
+            world.Step(STEP);
+            BallPhysics::StepFixed(ball, reference, STEP);
+            maxError = std::max(maxError, hypotf(world.GetX(index) - ball.x, world.GetY(index) - ball.y));
+            if (ball.moving != world.IsMoving(index)) stopMismatches++;
+        }
+    }
+    context.Log("100 shots: max distance from StepFixed %.4fpx", maxError);
+    SELFTEST_CHECK(context, maxError < 0.01f);
+    SELFTEST_CHECK(context, stopMismatches == 0);
+}
+
+// The 10k-ball field from the change that added BallWorld: radius 5-10 on a
+// 4096px square, everything launched at once, stepped at the game's rate
+SELFTEST_BENCHMARK(BallWorld_TenThousandBalls) {
+    const int BALLS = 10000;
+    const int STEPS = 240;
+    const float STEP = 1.0f / 120.0f;
+    const float SIZE = 4096.0f;
+
+    BallWorld world(SIZE, SIZE);
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> position(20.0f, SIZE - 20.0f);
+    std::uniform_real_distribution<float> radius(5.0f, 10.0f);
+    std::uniform_real_distribution<float> power(5.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    for (int i = 0; i < BALLS; i++) {
+        world.Launch(world.AddBall(position(rng), position(rng), radius(rng)), power(rng), angle(rng));
+    }
+
+    long long candidatePairs = 0;
+    long long contacts = 0;
+    double worstMs = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < STEPS; step++) {
+        const auto stepStart = std::chrono::steady_clock::now();
+        world.Step(STEP);
+        worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stepStart).count());
+        candidatePairs += world.GetCandidatePairs();
+        contacts += world.GetContacts();
+    }
+    const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int outside = 0;
+    for (int i = 0; i < world.GetCount(); i++) {
+        const float x = world.GetX(i);
+        const float y = world.GetY(i);
+        if (!(x >= 0.0f && x <= SIZE && y >= 0.0f && y <= SIZE)) outside++;
+    }
+
+#if defined(__AVX__)
+    const char* path = "AVX";
+#else
+    const char* path = "scalar 8-wide";
+#endif
+    context.Log("%d balls, %d steps (%s): %.3f ms/step, worst %.3f ms; %d still moving",
+                BALLS, STEPS, path, totalMs / STEPS, worstMs, world.GetMovingCount());
+    context.Log("%.0f candidate pairs and %.1f contacts per step", candidatePairs / double(STEPS), contacts / double(STEPS));
+    SELFTEST_CHECK(context, outside == 0);
+}
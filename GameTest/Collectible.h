@@ -1,18 +1,25 @@
 #pragma once
 #include "GameObject.h"
+#include "ObjectArena.h"
 #include "App/app.h"
 #include "GameEventManager.h"
+#include "CollisionDispatch.h"
 
 class Collectible : public GameObject {
+public:
+    static constexpr Type TYPE = Type::Collectible;
+
 private:
     bool m_isCollected;
     float m_radius;
 
 public:
     Collectible(float x, float y) 
-        : GameObject(x, y), m_isCollected(false), m_radius(8.0f) {}
+        : GameObject(x, y, TYPE), m_isCollected(false), m_radius(8.0f) {}
     
-    void Update(float deltaTime) override {}
+    void Update(SimSeconds deltaTime) override {}
+    bool NeedsUpdate() const override { return false; }
+    bool IsExpired() const override { return m_isCollected; }
     
     void Draw() override {
         if (!m_isCollected) {
@@ -27,9 +34,14 @@ public:
         }
     }
     
-    bool CheckCollision(const GameObject& other) override { return false; }
+    std::unique_ptr<GameObject> Clone() const override { return std::make_unique<Collectible>(*this); }
+    GameObject* CloneInto(ObjectArena& arena) const override { return arena.Create<Collectible>(*this); }
+    bool CheckCollision(const GameObject& other) override {
+        return CollisionDispatch::Collide(*this, other);
+    }
     
     bool IsCollected() const { return m_isCollected; }
+    float GetRadius() const { return m_radius; }
     void Collect() { 
         m_isCollected = true; 
         GameEventManager::GetInstance().Emit(GameEventManager::EventType::CollectibleCollected);
@@ -0,0 +1,93 @@
+#include "stdafx.h"
+#include "CollisionDispatch.h"
+#include "Ball.h"
+#include "Wall.h"
+#include "Enemy.h"
+#include "Collectible.h"
+#include "Hole.h"
+
+namespace CollisionDispatch {
+
+    namespace {
+        const int TYPE_COUNT = static_cast<int>(GameObject::Type::Count);
+
+        bool NoCollision(GameObject&, const GameObject&) {
+            return false;
+        }
+
+        bool BallBall(GameObject& self, const GameObject& other) {
+            // The impulse pushes both balls apart
+            return static_cast<Ball&>(self).HandleCollision(const_cast<Ball&>(static_cast<const Ball&>(other)));
+        }
+
+        bool BallWall(GameObject& self, const GameObject& other) {
+            Ball& ball = static_cast<Ball&>(self);
+            // A phasing ball passes through walls, so it never touches one
+            if (ball.IsPhaseMode()) return false;
+            return ball.HandleWallCollision(static_cast<const Wall&>(other));
+        }
+
+        bool BallEnemy(GameObject& self, const GameObject& other) {
+            return static_cast<Ball&>(self).HandleEnemyCollision(static_cast<const Enemy&>(other));
+        }
+
+        bool BallCollectible(GameObject& self, const GameObject& other) {
+            // Picking up is the collectible's state change, so it can't stay const
+            Collectible& collectible = const_cast<Collectible&>(static_cast<const Collectible&>(other));
+            return static_cast<Ball&>(self).HandleCollectibleCollision(collectible);
+        }
+
+        bool WallBall(GameObject& self, const GameObject& other) {
+            return static_cast<Wall&>(self).OverlapsBall(static_cast<const Ball&>(other));
+        }
+
+        bool EnemyAny(GameObject& self, const GameObject& other) {
+            return static_cast<Enemy&>(self).IsTouching(other);
+        }
+
+        bool HoleBall(GameObject& self, const GameObject& other) {
+            const Ball& ball = static_cast<const Ball&>(other);
+            float ballX, ballY;
+            ball.GetPosition(ballX, ballY);
+            return static_cast<Hole&>(self).IsInHole(ballX, ballY, ball.GetVelocityX(), ball.GetVelocityY());
+        }
+
+        struct HandlerTable {
+            Handler handlers[TYPE_COUNT][TYPE_COUNT];
+
+            HandlerTable() {
+                for (int a = 0; a < TYPE_COUNT; a++) {
+                    for (int b = 0; b < TYPE_COUNT; b++) {
+                        handlers[a][b] = NoCollision;
+                    }
+                }
+
+                Set(GameObject::Type::Ball, GameObject::Type::Ball, BallBall);
+                Set(GameObject::Type::Ball, GameObject::Type::Wall, BallWall);
+                Set(GameObject::Type::Ball, GameObject::Type::Enemy, BallEnemy);
+                Set(GameObject::Type::Ball, GameObject::Type::Collectible, BallCollectible);
+                Set(GameObject::Type::Wall, GameObject::Type::Ball, WallBall);
+                Set(GameObject::Type::Hole, GameObject::Type::Ball, HoleBall);
+
+                // Enemies report proximity to anything, as Enemy::CheckCollision always has
+                for (int b = 0; b < TYPE_COUNT; b++) {
+                    handlers[static_cast<int>(GameObject::Type::Enemy)][b] = EnemyAny;
+                }
+            }
+
+            void Set(GameObject::Type a, GameObject::Type b, Handler handler) {
+                handlers[static_cast<int>(a)][static_cast<int>(b)] = handler;
+            }
+        };
+
+        const HandlerTable table;
+    }
+
+    bool Collide(GameObject& self, const GameObject& other) {
+        return table.handlers[static_cast<int>(self.GetType())][static_cast<int>(other.GetType())](self, other);
+    }
+
+    Handler GetHandler(GameObject::Type self, GameObject::Type other) {
+        return table.handlers[static_cast<int>(self)][static_cast<int>(other)];
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "GameObject.h"
+
+// Collision responses indexed by (self type, other type). One pair check is
+// one table lookup and one call, with no casts beyond the static_cast the
+// entry does on types it already knows.
+namespace CollisionDispatch {
+
+    using Handler = bool (*)(GameObject& self, const GameObject& other);
+
+    // Applies self's response to touching other; returns whether they touched.
+    // Pairs with no entry (e.g. wall vs wall) do nothing and return false.
+    bool Collide(GameObject& self, const GameObject& other);
+
+    Handler GetHandler(GameObject::Type self, GameObject::Type other);
+}
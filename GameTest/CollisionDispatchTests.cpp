@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "CollisionDispatch.h"
+#include "Ball.h"
+#include "Wall.h"
+#include "Enemy.h"
+#include "Collectible.h"
+#include "Hole.h"
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    // The chain CheckCollision used before the table. Self's class was known
+    // from the virtual call, which the switch stands in for; the other
+    // object's class was probed with dynamic_cast until one matched.
+    bool CollideByCasting(GameObject& self, const GameObject& other) {
+        switch (self.GetType()) {
+            case GameObject::Type::Ball: {
+                Ball& ball = static_cast<Ball&>(self);
+                if (const Wall* wall = dynamic_cast<const Wall*>(&other)) {
+                    return !ball.IsPhaseMode() && ball.HandleWallCollision(*wall);
+                }
+                if (const Enemy* enemy = dynamic_cast<const Enemy*>(&other)) {
+                    return ball.HandleEnemyCollision(*enemy);
+                }
+                if (const Collectible* collectible = dynamic_cast<const Collectible*>(&other)) {
+                    return ball.HandleCollectibleCollision(const_cast<Collectible&>(*collectible));
+                }
+                if (const Ball* otherBall = dynamic_cast<const Ball*>(&other)) {
+                    return ball.HandleCollision(const_cast<Ball&>(*otherBall));
+                }
+                return false;
+            }
+            case GameObject::Type::Wall: {
+                const Ball* ball = dynamic_cast<const Ball*>(&other);
+                return ball && static_cast<Wall&>(self).OverlapsBall(*ball);
+            }
+            case GameObject::Type::Enemy:
+                return static_cast<Enemy&>(self).IsTouching(other);
+            case GameObject::Type::Hole: {
+                const Ball* ball = dynamic_cast<const Ball*>(&other);
+                if (!ball) return false;
+                float ballX, ballY;
+                ball->GetPosition(ballX, ballY);
+                return static_cast<Hole&>(self).IsInHole(ballX, ballY, ball->GetVelocityX(), ball->GetVelocityY());
+            }
+            default:
+                return false;
+        }
+    }
+
+    // `count` walls, enemies and collectibles in random order over the screen
+    std::vector<std::unique_ptr<GameObject>> MakeMixedObjects(int count) {
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> x(0.0f, 1024.0f);
+        std::uniform_real_distribution<float> y(0.0f, 768.0f);
+        std::vector<std::unique_ptr<GameObject>> objects;
+        for (int i = 0; i < count; i++) {
+            switch (rng() % 3) {
+                case 0: objects.push_back(std::make_unique<Wall>(x(rng), y(rng), 40.0f, 20.0f)); break;
+                case 1: objects.push_back(std::make_unique<Enemy>(x(rng), y(rng))); break;
+                default: objects.push_back(std::make_unique<Collectible>(x(rng), y(rng))); break;
+            }
+        }
+        return objects;
+    }
+}
+
+SELFTEST_CASE(CollisionDispatch_BallWallReportsContact) {
+    const Wall wall(200.0f, 200.0f, 40.0f, 40.0f);
+
+    // Clear of the wall: no contact, no push
+    Ball apart(100.0f, 200.0f);
+    SELFTEST_CHECK(context, !CollisionDispatch::Collide(apart, wall));
+    float x, y;
+    apart.GetPosition(x, y);
+    SELFTEST_CHECK(context, x == 100.0f && y == 200.0f);
+
+    // Overlapping the left face: pushed out to the left and reported
+    Ball touching(175.0f, 200.0f);
+    SELFTEST_CHECK(context, CollisionDispatch::Collide(touching, wall));
+    touching.GetPosition(x, y);
+    SELFTEST_CHECK(context, x <= 180.0f - touching.GetRadius());
+
+    // Phasing through the same overlap: untouched and not reported
+    Ball phasing(175.0f, 200.0f);
+    phasing.SetPhaseMode(true);
+    SELFTEST_CHECK(context, !CollisionDispatch::Collide(phasing, wall));
+    phasing.GetPosition(x, y);
+    SELFTEST_CHECK(context, x == 175.0f);
+}
+
+SELFTEST_CASE(CollisionDispatch_UnhandledPairsDoNothing) {
+    Wall wall(200.0f, 200.0f, 40.0f, 40.0f);
+    const Wall other(200.0f, 200.0f, 40.0f, 40.0f);
+    SELFTEST_CHECK(context, !CollisionDispatch::Collide(wall, other));
+    SELFTEST_CHECK(context, CollisionDispatch::GetHandler(GameObject::Type::Wall, GameObject::Type::Wall) ==
+                            CollisionDispatch::GetHandler(GameObject::Type::Collectible, GameObject::Type::Wall));
+}
+
+// Both directions of every ball/object pair, the way Level used to check
+// them, through the old cast chain and through the table. Each way starts
+// from its own copy of the scene, so the hit counts must agree.
+SELFTEST_BENCHMARK(CollisionDispatch_TableVsDynamicCast) {
+    const int OBJECTS = 1000;
+    const int ROUNDS = 2000;
+
+    struct Way {
+        const char* name;
+        bool (*collide)(GameObject&, const GameObject&);
+        double bestNs;
+        int firstRoundHits;
+    };
+    Way ways[] = {
+        { "dynamic_cast chain", CollideByCasting, 0.0, 0 },
+        { "type table", CollisionDispatch::Collide, 0.0, 0 },
+    };
+
+    for (Way& way : ways) {
+        std::vector<std::unique_ptr<GameObject>> objects = MakeMixedObjects(OBJECTS);
+        Ball ball(512.0f, 384.0f);
+        way.bestNs = 1e30;
+        for (int round = 0; round < ROUNDS; round++) {
+            int hits = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& object : objects) {
+                hits += way.collide(ball, *object);
+                hits += way.collide(*object, ball);
+            }
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            way.bestNs = std::min(way.bestNs, ns / OBJECTS);
+            if (round == 0) way.firstRoundHits = hits;
+        }
+        context.Log("%s: %.1f ns per object (both directions), %d hits in the first round",
+                    way.name, way.bestNs, way.firstRoundHits);
+    }
+    SELFTEST_CHECK(context, ways[0].firstRoundHits == ways[1].firstRoundHits);
+}
@@ -0,0 +1,223 @@
+#include "stdafx.h"
+#include "CourseTemplates.h"
+
+namespace CourseTemplates {
+
+    namespace {
+        constexpr double PI = 3.14159265358979323846;
+
+        // std::sin/cos aren't constexpr. Twenty Taylor terms are exact to
+        // double precision on [-pi, pi], so rounding to float gives what
+        // sinf/cosf return for the same float argument.
+        constexpr double ReduceAngle(double x) {
+            while (x > PI) x -= 2.0 * PI;
+            while (x < -PI) x += 2.0 * PI;
+            return x;
+        }
+
+        constexpr float Sin(float radians) {
+            double x = ReduceAngle(radians);
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 20; n++) {
+                term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+                sum += term;
+            }
+            return static_cast<float>(sum);
+        }
+
+        constexpr float Cos(float radians) {
+            double x = ReduceAngle(radians);
+            double term = 1.0;
+            double sum = 1.0;
+            for (int n = 1; n < 20; n++) {
+                term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+                sum += term;
+            }
+            return static_cast<float>(sum);
+        }
+
+        constexpr float ToRadians(float degrees) {
+            return degrees * 3.14159f / 180.0f;
+        }
+
+        constexpr void AddWall(CourseTable& table, float x, float y, float width, float height, float rotation) {
+            WallTemplate& wall = table.walls[table.wallCount++];
+            wall.relativeX = x;
+            wall.relativeY = y;
+            wall.width = width;
+            wall.height = height;
+            wall.rotation = rotation;
+        }
+
+        constexpr void AddPoint(TemplatePoint* points, int& count, float x, float y) {
+            points[count].x = x;
+            points[count].y = y;
+            count++;
+        }
+
+        // Template 1: Dense Zigzag Maze
+        constexpr CourseTable MakeZigzag() {
+            CourseTable zigzag{};
+            zigzag.startX = 0.1f;
+            zigzag.startY = 0.5f;
+            zigzag.holeX = 0.9f;
+            zigzag.holeY = 0.5f;
+
+            // Create a denser zigzag pattern with multiple layers
+            for (float x = 0.2f; x < 0.9f; x += 0.1f) {
+                AddWall(zigzag, x, 0.3f, 150.0f, 20.0f, 0.0f);
+                AddWall(zigzag, x + 0.05f, 0.7f, 150.0f, 20.0f, 0.0f);
+            }
+            // Add vertical barriers
+            for (float x = 0.25f; x < 0.85f; x += 0.2f) {
+                AddWall(zigzag, x, 0.5f, 20.0f, 200.0f, 0.0f);
+            }
+
+            // Add collectibles along the path
+            for (float x = 0.25f; x < 0.85f; x += 0.15f) {
+                AddPoint(zigzag.collectibles, zigzag.collectibleCount, x, 0.5f);
+            }
+
+            // Add enemies guarding the path
+            AddPoint(zigzag.enemies, zigzag.enemyCount, 0.3f, 0.5f);
+            AddPoint(zigzag.enemies, zigzag.enemyCount, 0.6f, 0.5f);
+            AddPoint(zigzag.enemies, zigzag.enemyCount, 0.8f, 0.5f);
+            return zigzag;
+        }
+
+        // Template 2: Spiral Maze. Five walls wind out from the hole in the
+        // middle to an opening on the right, where the ball starts. The level
+        // is 700x300, so in pixels from the middle the arms sit at y -92,
+        // +140 and -140 and x +150 and -230: the innermost one stays clear
+        // of the hole's jitter box (50 either way plus a 30 margin), and every
+        // corridor is wider than the ball.
+        constexpr CourseTable MakeSpiral() {
+            CourseTable spiral{};
+            spiral.startX = 0.95f;
+            spiral.startY = 0.5f;
+            spiral.holeX = 0.5f;
+            spiral.holeY = 0.5f;
+
+            AddWall(spiral, 0.5f, 0.1933f, 320.0f, 20.0f, 0.0f);      // Inner top
+            AddWall(spiral, 0.7143f, 0.58f, 20.0f, 252.0f, 0.0f);     // Right
+            AddWall(spiral, 0.4429f, 0.9667f, 400.0f, 20.0f, 0.0f);   // Bottom
+            AddWall(spiral, 0.1714f, 0.5f, 20.0f, 300.0f, 0.0f);      // Left
+            AddWall(spiral, 0.5f, 0.0333f, 480.0f, 20.0f, 0.0f);      // Outer top
+
+            // Collectibles along the corridors, from the opening inwards
+            AddPoint(spiral.collectibles, spiral.collectibleCount, 0.7714f, 0.5f);
+            for (float x = 0.7f; x > 0.25f; x -= 0.2f) {
+                AddPoint(spiral.collectibles, spiral.collectibleCount, x, 0.1133f);
+            }
+            AddPoint(spiral.collectibles, spiral.collectibleCount, 0.2286f, 0.5f);
+
+            // Enemies at strategic points
+            AddPoint(spiral.enemies, spiral.enemyCount, 0.7714f, 0.3f);
+            AddPoint(spiral.enemies, spiral.enemyCount, 0.35f, 0.1133f);
+            AddPoint(spiral.enemies, spiral.enemyCount, 0.5f, 0.75f);
+            return spiral;
+        }
+
+        // Template 3: Grid Maze. Which cells get walls is rolled per level.
+        constexpr CourseTable MakeGrid() {
+            CourseTable grid{};
+            grid.startX = 0.1f;
+            grid.startY = 0.1f;
+            grid.holeX = 0.9f;
+            grid.holeY = 0.9f;
+            grid.variation = TemplateVariation::GridWalls;
+
+            // Create a dense grid pattern
+            for (float x = 0.2f; x < 0.9f; x += 0.15f) {
+                for (float y = 0.2f; y < 0.9f; y += 0.15f) {
+                    AddPoint(grid.cells, grid.cellCount, x, y);
+                }
+            }
+
+            // Add collectibles to grid
+            for (float x = 0.3f; x < 0.8f; x += 0.2f) {
+                for (float y = 0.3f; y < 0.8f; y += 0.2f) {
+                    AddPoint(grid.collectibles, grid.collectibleCount, x, y);
+                }
+            }
+            AddPoint(grid.enemies, grid.enemyCount, 0.4f, 0.4f);
+            AddPoint(grid.enemies, grid.enemyCount, 0.6f, 0.6f);
+            AddPoint(grid.enemies, grid.enemyCount, 0.4f, 0.6f);
+            AddPoint(grid.enemies, grid.enemyCount, 0.6f, 0.4f);
+            return grid;
+        }
+
+        // Template 4: Pinball Style. The inner obstacles are rolled per level.
+        constexpr CourseTable MakePinball() {
+            CourseTable pinball{};
+            pinball.startX = 0.1f;
+            pinball.startY = 0.1f;
+            pinball.holeX = 0.9f;
+            pinball.holeY = 0.9f;
+            pinball.variation = TemplateVariation::PinballObstacles;
+
+            // Add circular arrangement of walls
+            for (float angle = 0; angle < 360; angle += 30) {
+                float x = 0.5f + 0.3f * Cos(ToRadians(angle));
+                float y = 0.5f + 0.3f * Sin(ToRadians(angle));
+                AddWall(pinball, x, y, 80.0f, 20.0f, angle);
+            }
+
+            // Add collectibles and enemies to pinball template
+            for (float angle = 0; angle < 360; angle += 45) {
+                float x = 0.5f + 0.2f * Cos(ToRadians(angle));
+                float y = 0.5f + 0.2f * Sin(ToRadians(angle));
+                AddPoint(pinball.collectibles, pinball.collectibleCount, x, y);
+            }
+            AddPoint(pinball.enemies, pinball.enemyCount, 0.5f, 0.3f);
+            AddPoint(pinball.enemies, pinball.enemyCount, 0.3f, 0.5f);
+            AddPoint(pinball.enemies, pinball.enemyCount, 0.7f, 0.5f);
+            return pinball;
+        }
+
+        // Template 5: Concentric Circles
+        constexpr CourseTable MakeCircles() {
+            CourseTable circles{};
+            circles.startX = 0.1f;
+            circles.startY = 0.5f;
+            circles.holeX = 0.9f;
+            circles.holeY = 0.5f;
+
+            // Create concentric circle pattern using short walls
+            for (float radius = 0.1f; radius < 0.4f; radius += 0.08f) {
+                for (float angle = 0; angle < 360; angle += 20) {
+                    float x = 0.5f + radius * Cos(ToRadians(angle));
+                    float y = 0.5f + radius * Sin(ToRadians(angle));
+                    AddWall(circles, x, y, 40.0f, 20.0f, angle);
+                }
+            }
+
+            // Add collectibles and enemies to circles template
+            for (float radius = 0.15f; radius < 0.35f; radius += 0.1f) {
+                for (float angle = 0; angle < 360; angle += 60) {
+                    float x = 0.5f + radius * Cos(ToRadians(angle));
+                    float y = 0.5f + radius * Sin(ToRadians(angle));
+                    AddPoint(circles.collectibles, circles.collectibleCount, x, y);
+                }
+            }
+            AddPoint(circles.enemies, circles.enemyCount, 0.5f, 0.5f);
+            AddPoint(circles.enemies, circles.enemyCount, 0.3f, 0.5f);
+            AddPoint(circles.enemies, circles.enemyCount, 0.7f, 0.5f);
+            return circles;
+        }
+
+        // Constant-initialized: no code runs for these at startup
+        constexpr CourseTable TABLES[COUNT] = {
+            MakeZigzag(),
+            MakeSpiral(),
+            MakeGrid(),
+            MakePinball(),
+            MakeCircles()
+        };
+    }
+
+    const CourseTable& Get(int index) {
+        return TABLES[index];
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <utility>  // for std::pair
+#include <vector>
+
+struct WallTemplate {
+    float relativeX;      // Position relative to level width (0.0 to 1.0)
+    float relativeY;      // Position relative to level height (0.0 to 1.0)
+    float width;
+    float height;
+    float rotation;       // Rotation in degrees
+};
+
+// The random part of a template, rolled per level by LevelGenerator
+enum class TemplateVariation : uint8_t {
+    None,
+    GridWalls,          // A cross of walls on 70% of `cells`
+    PinballObstacles    // Eight short walls at random in the middle
+};
+
+struct CourseTemplate {
+    std::vector<WallTemplate> walls;
+    std::vector<std::pair<float, float>> collectibles;  // Relative positions (x,y)
+    std::vector<std::pair<float, float>> enemies;       // Relative positions (x,y)
+    float startX;         // Relative start position (0.0 to 1.0)
+    float startY;
+    float holeX;         // Relative hole position (0.0 to 1.0)
+    float holeY;
+    TemplateVariation variation = TemplateVariation::None;
+    std::vector<std::pair<float, float>> cells;         // GridWalls candidates
+};
+
+struct TemplatePoint {
+    float x, y;
+};
+
+// Fixed part of a course template. Built at compile time (CourseTemplates.cpp),
+// so a LevelGenerator has nothing to set up.
+struct CourseTable {
+    static constexpr int MAX_WALLS = 96;
+    static constexpr int MAX_POINTS = 32;
+
+    WallTemplate walls[MAX_WALLS];
+    int wallCount;
+    TemplatePoint collectibles[MAX_POINTS];
+    int collectibleCount;
+    TemplatePoint enemies[MAX_POINTS];
+    int enemyCount;
+    TemplatePoint cells[MAX_POINTS];    // GridWalls candidates
+    int cellCount;
+    float startX, startY;
+    float holeX, holeY;
+    TemplateVariation variation;
+};
+
+namespace CourseTemplates {
+    constexpr int COUNT = 5;
+
+    const CourseTable& Get(int index);
+}
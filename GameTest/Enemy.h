@@ -1,24 +1,19 @@
 #pragma once
 #include "GameObject.h"
+#include "ObjectArena.h"
 #include "App/app.h"
+#include "EnemyPatrol.h"
+#include "CollisionDispatch.h"
 #include <cmath>
 
 class Enemy : public GameObject {
 public:
-    enum class Pattern {
-        Circular,
-        Linear,
-        Stationary
-    };
+    using Pattern = PatrolPattern;
+    static constexpr Type TYPE = Type::Enemy;
 
 private:
-    Pattern m_pattern;
-    float m_speed;
-    float m_patrolRadius;
-    float m_patrolDistance;
+    EnemyPatrol m_patrol;
     float m_angle;
-    float m_startX;
-    float m_startY;
     float m_time;
     float m_size;
     bool m_isAlive;
@@ -28,14 +23,9 @@ private:
 
 public:
     Enemy(float x, float y, Pattern pattern = Pattern::Circular) 
-        : GameObject(x, y)
-        , m_pattern(pattern)
-        , m_speed(100.0f)
-        , m_patrolRadius(50.0f)
-        , m_patrolDistance(100.0f)
+        : GameObject(x, y, TYPE)
+        , m_patrol{ pattern, x, y, 100.0f, 50.0f, 100.0f }
         , m_angle(0.0f)
-        , m_startX(x)
-        , m_startY(y)
         , m_time(0.0f)
         , m_size(10.0f)
         , m_isAlive(true)
@@ -46,9 +36,11 @@ public:
         m_height = 20.0f;
     }
 
-    void Update(float deltaTime) override {
+    void Update(SimSeconds deltaTime) override {
+        const float dt = deltaTime.count();
+
         if (m_isExploding) {
-            m_explosionTime += deltaTime;
+            m_explosionTime += dt;
             if (m_explosionTime >= EXPLOSION_DURATION) {
                 m_isAlive = false;
             }
@@ -57,25 +49,17 @@ public:
 
         if (!m_isAlive) return;
 
-        m_time += deltaTime;
-        
-        switch (m_pattern) {
-            case Pattern::Circular:
-                m_angle += m_speed * deltaTime;
-                m_posX = m_startX + cos(m_angle * 0.05f) * m_patrolRadius;
-                m_posY = m_startY + sin(m_angle * 0.05f) * m_patrolRadius;
-                break;
-
-            case Pattern::Linear:
-                m_posX = m_startX + cos(m_time * m_speed * 0.05f) * m_patrolDistance;
-                break;
-
-            case Pattern::Stationary:
-                m_angle += m_speed * deltaTime;
-                break;
+        m_time += dt;
+        if (m_patrol.pattern != Pattern::Linear) {
+            m_angle += m_patrol.speed * dt;
         }
+        m_patrol.Evaluate(m_angle, m_time, m_posX, m_posY);
     }
 
+    // Alive covers exploding too; a finished explosion is never ticked again
+    bool NeedsUpdate() const override { return m_isAlive; }
+    bool IsExpired() const override { return !m_isAlive; }
+
     void Draw() override {
         if (!m_isAlive && !m_isExploding) return;
 
@@ -108,7 +92,13 @@ public:
         App::DrawLine(x3, y3, x1, y1, 1.0f, 0.0f, 0.0f);
     }
 
+    std::unique_ptr<GameObject> Clone() const override { return std::make_unique<Enemy>(*this); }
+    GameObject* CloneInto(ObjectArena& arena) const override { return arena.Create<Enemy>(*this); }
     bool CheckCollision(const GameObject& other) override {
+        return CollisionDispatch::Collide(*this, other);
+    }
+
+    bool IsTouching(const GameObject& other) const {
         if (!m_isAlive || m_isExploding) return false;
 
         float otherX, otherY;
@@ -129,9 +119,23 @@ public:
     }
 
     // Getters and Setters
-    void SetSpeed(float speed) { m_speed = speed; }
-    void SetPatrolRadius(float radius) { m_patrolRadius = radius; }
-    void SetPatrolDistance(float distance) { m_patrolDistance = distance; }
+    void SetSpeed(float speed) { m_patrol.speed = speed; }
+    void SetPatrolRadius(float radius) { m_patrol.patrolRadius = radius; }
+    void SetPatrolDistance(float distance) { m_patrol.patrolDistance = distance; }
+    const EnemyPatrol& GetPatrol() const { return m_patrol; }
+
+    // Where Update() will have put the enemy after `secondsAhead` more seconds
+    // of ticks. Exploding or dead enemies stay put.
+    void GetPositionAt(float secondsAhead, float& x, float& y) const {
+        if (!m_isAlive || m_isExploding || secondsAhead <= 0.0f) {
+            x = m_posX;
+            y = m_posY;
+            return;
+        }
+        m_patrol.EvaluateAhead(m_angle, m_time, secondsAhead, x, y);
+    }
+    float GetPatrolAngle() const { return m_angle; }
+    float GetPatrolTime() const { return m_time; }
     float GetSize() const { return m_size; }
     bool IsAlive() const { return m_isAlive; }
     bool IsExploding() const { return m_isExploding; }
@@ -0,0 +1,54 @@
+#pragma once
+#include <cmath>
+
+enum class PatrolPattern {
+    Circular,
+    Linear,
+    Stationary
+};
+
+// An enemy's patrol is closed-form in its two clocks: Circular and Stationary
+// advance `angle` by speed*dt, Linear runs off `time`. Headless so shot
+// prediction can place enemies without ticking them.
+struct EnemyPatrol {
+    PatrolPattern pattern;
+    float startX, startY;
+    float speed;
+    float patrolRadius;
+    float patrolDistance;
+
+    void Evaluate(float angle, float time, float& x, float& y) const {
+        switch (pattern) {
+            case PatrolPattern::Circular:
+                x = startX + cosf(angle * 0.05f) * patrolRadius;
+                y = startY + sinf(angle * 0.05f) * patrolRadius;
+                break;
+
+            case PatrolPattern::Linear:
+                x = startX + cosf(time * speed * 0.05f) * patrolDistance;
+                y = startY;
+                break;
+
+            case PatrolPattern::Stationary:
+            default:
+                x = startX;
+                y = startY;
+                break;
+        }
+    }
+
+    // Position `ahead` seconds after the clocks read (angle, time), without stepping
+    void EvaluateAhead(float angle, float time, float ahead, float& x, float& y) const {
+        float futureAngle = pattern != PatrolPattern::Linear ? angle + speed * ahead : angle;
+        Evaluate(futureAngle, time + ahead, x, y);
+    }
+
+    // Every position the patrol can reach lies within this distance of the start
+    float GetReach() const {
+        switch (pattern) {
+            case PatrolPattern::Circular: return fabsf(patrolRadius);
+            case PatrolPattern::Linear:   return fabsf(patrolDistance);
+            default:                      return 0.0f;
+        }
+    }
+};
@@ -1,18 +1,46 @@
 #pragma once
 #include "App/app.h"
+#include "SimClock.h"
+#include <cstdint>
+#include <memory>
+
+class ObjectArena;
 
 class GameObject {
+public:
+    // Concrete type, fixed at construction. Indexes the collision table
+    // (CollisionDispatch) and backs ObjectCast.
+    enum class Type : uint8_t {
+        Ball,
+        Wall,
+        Enemy,
+        Collectible,
+        Hole,
+        Count
+    };
+
 protected:
     float m_posX, m_posY;
     float m_width, m_height;
+    const Type m_type;
 
 public:
-    GameObject(float x, float y) : m_posX(x), m_posY(y), m_width(0), m_height(0) {}
+    GameObject(float x, float y, Type type) : m_posX(x), m_posY(y), m_width(0), m_height(0), m_type(type) {}
     virtual ~GameObject() = default;
+
+    Type GetType() const { return m_type; }
     
-    virtual void Update(float deltaTime) = 0;
+    virtual void Update(SimSeconds deltaTime) = 0;
+    // False once Update would do nothing; Level then stops ticking the object
+    virtual bool NeedsUpdate() const { return true; }
+    // True once the object is gone for good; Level removes it at the end of the tick
+    virtual bool IsExpired() const { return false; }
     virtual void Draw() = 0;
     virtual bool CheckCollision(const GameObject& other) = 0;
+    // Copy in the same state, for restoring cached levels
+    virtual std::unique_ptr<GameObject> Clone() const = 0;
+    // The same copy, built in `arena` instead of on the heap
+    virtual GameObject* CloneInto(ObjectArena& arena) const = 0;
     
     virtual void GetPosition(float& x, float& y) const {
         x = m_posX;
@@ -24,3 +52,33 @@ public:
         m_posY = y;
     }
 };
+
+// Tag-checked downcast for classes that declare a TYPE constant; nullptr on mismatch
+template<typename T>
+T* ObjectCast(GameObject* obj) {
+    return obj && obj->GetType() == T::TYPE ? static_cast<T*>(obj) : nullptr;
+}
+
+template<typename T>
+const T* ObjectCast(const GameObject* obj) {
+    return obj && obj->GetType() == T::TYPE ? static_cast<const T*>(obj) : nullptr;
+}
+
+// Owner of a Level's objects. Heap objects are deleted; objects living in the
+// level's ObjectArena are only destroyed, the arena frees their memory. Any
+// std::unique_ptr to a GameObject converts to one that deletes.
+struct ObjectDeleter {
+    bool inArena = false;
+
+    ObjectDeleter() = default;
+    explicit ObjectDeleter(bool arena) : inArena(arena) {}
+    template<typename T>
+    ObjectDeleter(const std::default_delete<T>&) {}
+
+    void operator()(GameObject* obj) const {
+        if (inArena) obj->~GameObject();
+        else delete obj;
+    }
+};
+
+using ObjectPtr = std::unique_ptr<GameObject, ObjectDeleter>;
@@ -12,7 +12,18 @@
 #include "Enemy.h"
 #include "Collectible.h"
 #include "LevelGenerator.h"
+#include "LevelPipeline.h"
+#include "LevelGenBenchmark.h"
+#include "TemplateLibrary.h"
 #include "PowerupSystem.h"
+#include "SimClock.h"
+#include "ShotSimulator.h"
+#include "TrajectoryCache.h"
+#include "SelfTest.h"
+#include <chrono>
+#include <cwctype>
+#include <fstream>
+#include <random>
 
 // Add at the top of the file with other includes
 #define _USE_MATH_DEFINES
@@ -55,9 +66,28 @@ enum GameState {
 };
 GameState gameState = MENU;
 
-// Physics timestep
-const float FIXED_TIMESTEP = 1.0f / 240.0f;
-float accumulator = 0.0f;
+// Physics clock: the only place frame time is turned into fixed simulation steps
+FixedStepClock simClock;
+
+// Aim preview path, re-simulated on a worker only when the aim, ball or level changes.
+// Built in Init() so the worker thread only runs for the game, not --selftest.
+std::unique_ptr<TrajectoryCache> aimPreviewCache;
+
+#ifdef _DEBUG
+// Debug overlay: smoothed wall-clock cost of the level's fixed steps each frame
+float levelUpdateMs = 0.0f;
+const int STRESS_COLLECTIBLES = 600;
+
+// 'B' on the menu benchmarks the level generator
+bool benchmarkKeyDown = false;
+char benchmarkSummary[128] = "";
+#endif
+
+// Where the level generator benchmark writes its numbers unless told otherwise
+const char* const BENCHMARK_PATH = ".\\LevelGenBenchmark.json";
+
+// Where --selftest writes the full report
+const char* const SELFTEST_REPORT_PATH = ".\\SelfTest.txt";
 
 // Add these constants at the top with your other constants
 const int PROJECTION_DOTS = 10;  // Number of dots to show in the projection
@@ -90,16 +120,59 @@ std::vector<Powerup> currentPowerupChoices;
 const float POWERUP_BUTTON_WIDTH = 200.0f;
 const float POWERUP_BUTTON_HEIGHT = 150.0f;
 
+// Levels are built on a worker; one seed per course reproduces the whole run.
+// The worker also checks each new layout can be holed within par.
+LevelGenerator::Validation MakeLevelValidation() {
+    LevelGenerator::Validation validation;
+    validation.enabled = true;
+    validation.search.maxPower = MAX_POWER;
+    return validation;
+}
+
+// Course templates come from a text file, re-read when it's saved so layouts
+// can be tuned with the game running. Without it the built-in ones are used.
+TemplateLibrary courseTemplates;
+const char* const COURSE_TEMPLATES_PATH = ".\\TestData\\Courses.txt";
+const float TEMPLATE_POLL_MS = 500.0f;
+float templatePollMs = 0.0f;
+
+LevelPipeline levelPipeline(MakeLevelValidation(), &courseTemplates);
+const int LEVEL_LOOKAHEAD = 2;  // Next-level builds kept in flight
+
+// Benchmarks the level generator on the current course templates and writes
+// the JSON to `path`. Runs on the calling thread; `summary` gets one line.
+bool RunLevelGenBenchmark(const std::string& path, char* summary, size_t summarySize) {
+    LevelGenBenchmark::Options options;
+    options.templates = &courseTemplates;
+    const LevelGenBenchmark::Result result = LevelGenBenchmark::Run(options);
+    const bool written = LevelGenBenchmark::WriteJson(path, result);
+    snprintf(summary, summarySize, "Benchmark: %d levels  %.0f levels/s  %.1f allocations/level  %s",
+             result.total.levels, result.total.LevelsPerSecond(),
+             result.total.allocations / static_cast<double>(std::max(result.total.levels, 1)),
+             written ? path.c_str() : "couldn't write results");
+    return written && result.total.levels > 0;
+}
+
 void CreateCourse() {
-    LevelGenerator generator;
+    levelPipeline.Start(std::random_device()());
     
     // Generate initial set of levels
     for (int i = 0; i < 3; i++) {  // Start with 3 levels
-        levels.push_back(generator.GenerateLevel(i));
+        levelPipeline.Enqueue(i);
+    }
+    for (int i = 0; i < 3; i++) {
+        levels.push_back(levelPipeline.Take());
+    }
+
+    // Each completed hole appends level currentHoleIndex + 1; start on those now
+    for (int i = 1; i <= LEVEL_LOOKAHEAD; i++) {
+        levelPipeline.Enqueue(i);
     }
 }
 
 void Init() {
+    aimPreviewCache.reset(new TrajectoryCache());
+    courseTemplates.Load(COURSE_TEMPLATES_PATH);
     CreateCourse();
     currentLevel = std::move(levels[0]);
     remainingStrokes = INITIAL_STROKES;
@@ -132,15 +205,45 @@ void Init() {
     }
 }
 
+// deltaTime arrives from App/main.cpp in milliseconds
 void Update(float deltaTime) {
     float mouseX, mouseY;
     App::GetMousePos(mouseX, mouseY);
+
+    // Holes not handed out yet are rebuilt from edited templates
+    templatePollMs += deltaTime;
+    if (templatePollMs >= TEMPLATE_POLL_MS) {
+        templatePollMs = 0.0f;
+        if (courseTemplates.PollForChanges()) {
+            levelPipeline.Rebuild();
+        }
+    }
     
     switch (gameState) {
         case MENU:
             if (App::IsKeyPressed(VK_LBUTTON)) {
+                simClock.Reset();
+                gameState = PLAYING;
+            }
+#ifdef _DEBUG
+            // 'C' swaps the first hole for the collectible stress scene
+            else if (App::IsKeyPressed('C')) {
+                LevelGenerator generator;
+                currentLevel = generator.GenerateCollectibleStressLevel(STRESS_COLLECTIBLES);
+                simClock.Reset();
                 gameState = PLAYING;
             }
+            // Runs here on the main thread; the menu stalls until it's done
+            else if (App::IsKeyPressed('B')) {
+                if (!benchmarkKeyDown) {
+                    RunLevelGenBenchmark(BENCHMARK_PATH, benchmarkSummary, sizeof(benchmarkSummary));
+                }
+                benchmarkKeyDown = true;
+            }
+            else {
+                benchmarkKeyDown = false;
+            }
+#endif
             break;
             
         case PLAYING: {
@@ -151,8 +254,19 @@ void Update(float deltaTime) {
             Ball* ball = currentLevel->GetBall();
             if (!ball) return;
 
-            // Update level
-            currentLevel->Update(deltaTime);
+            // Update level in fixed steps
+            const int steps = simClock.Advance(FrameMilliseconds(deltaTime));
+#ifdef _DEBUG
+            const auto updateStart = std::chrono::steady_clock::now();
+#endif
+            currentLevel->BeginFrame();
+            for (int i = 0; i < steps; i++) {
+                currentLevel->Update(simClock.GetStep());
+            }
+#ifdef _DEBUG
+            const FrameMilliseconds updateTime = std::chrono::steady_clock::now() - updateStart;
+            levelUpdateMs = levelUpdateMs * 0.9f + updateTime.count() * 0.1f;
+#endif
             
             // Mouse drag controls
             if (!ball->IsMoving()) {
@@ -215,15 +329,16 @@ void Update(float deltaTime) {
                         // Then apply the powerup cost
                         remainingStrokes -= selected.shotCost;
                         
-                        // Generate and move to next level
-                        LevelGenerator generator;
-                        levels.push_back(generator.GenerateLevel(currentHoleIndex + 1));
+                        // Pick up the pre-built next level and queue the one after
+                        levels.push_back(levelPipeline.Take());
+                        levelPipeline.Enqueue(currentHoleIndex + 1 + LEVEL_LOOKAHEAD);
                         currentHoleIndex++;
                         currentLevel = std::move(levels[currentHoleIndex]);
                         
                         // Apply the powerup to the new level's ball
                         powerupSystem.ApplyPowerup(selected, currentLevel->GetBall());
                         
+                        simClock.Reset();
                         gameState = PLAYING;
                         break;
                     }
@@ -247,7 +362,7 @@ void Render() {
             
         case PLAYING:
             if (currentLevel) {
-                currentLevel->Draw();
+                currentLevel->Draw(simClock.GetAlpha());
                 RenderHUD();
                 RenderAimingLine();
                 
@@ -272,10 +387,65 @@ void Render() {
 }
 
 void Shutdown() {
+    levelPipeline.Cancel();
+    // Joins the preview worker
+    aimPreviewCache.reset();
     currentLevel.reset();
     levels.clear();
 }
 
+// Release builds have no console of their own; use the one we were started from
+void WriteToConsole(const std::string& text) {
+    FILE* console = nullptr;
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        freopen_s(&console, "CONOUT$", "w", stdout);
+    }
+    fputs(text.c_str(), stdout);
+    fflush(stdout);
+}
+
+// Headless runs, for scripts and CI; no window is opened:
+//   GameTest.exe --selftest [filter]              quick checks
+//   GameTest.exe --selftest-benchmarks [filter]   quick checks plus the timed cases
+//   GameTest.exe --levelgen-benchmark [path]      LevelGenBenchmark, JSON to `path` (BENCHMARK_PATH)
+// Self-test reports go to the console and SELFTEST_REPORT_PATH, the benchmark
+// prints a summary line. The exit code is 1 if anything failed.
+bool RunCommandLine(const wchar_t* commandLine, int& exitCode) {
+    // Switches and case names are plain ASCII, so a narrowing copy will do
+    std::vector<std::string> args;
+    for (const wchar_t* c = commandLine; c && *c; c++) {
+        if (iswspace(*c)) continue;
+        args.emplace_back();
+        for (; *c && !iswspace(*c); c++) {
+            args.back() += static_cast<char>(*c);
+        }
+        if (!*c) break;
+    }
+    if (args.empty()) return false;
+
+    if (args[0] == "--levelgen-benchmark") {
+        // Same templates the game would use; the built-in ones without the file
+        courseTemplates.Load(COURSE_TEMPLATES_PATH);
+        char summary[256];
+        const bool ran = RunLevelGenBenchmark(args.size() > 1 ? args[1] : BENCHMARK_PATH, summary, sizeof(summary));
+        WriteToConsole(std::string(summary) + "\n");
+        exitCode = ran ? 0 : 1;
+        return true;
+    }
+
+    const bool selfTest = args[0] == "--selftest";
+    const bool benchmarks = args[0] == "--selftest-benchmarks";
+    if (!selfTest && !benchmarks) return false;
+
+    std::string report;
+    const SelfTest::Summary summary = SelfTest::Run(args.size() > 1 ? args[1] : "", benchmarks, report);
+    std::ofstream(SELFTEST_REPORT_PATH, std::ios::trunc) << report;
+    WriteToConsole(report);
+
+    exitCode = summary.failedCases > 0 || summary.cases == 0 ? 1 : 0;
+    return true;
+}
+
 // Helper functions
 void HandleDragging(float mouseX, float mouseY, float ballX, float ballY) {
     float dx = mouseX - dragStartX;
@@ -316,6 +486,9 @@ void ResetGame() {
 void RenderMenu() {
     App::Print(300, 300, "Albatross");
     App::Print(300, 250, "Click to Start");
+#ifdef _DEBUG
+    if (benchmarkSummary[0]) App::Print(300, 200, benchmarkSummary);
+#endif
 }
 
 void RenderHUD() {
@@ -332,6 +505,51 @@ void RenderHUD() {
     if (currentLevel) {
         sprintf_s(buffer, "Par: %d", currentLevel->GetPar());
         App::Print(10, 70, buffer);
+
+#ifdef _DEBUG
+        char debugBuffer[96];
+        sprintf_s(debugBuffer, "Objects: %d  Update: %.3f ms",
+                  static_cast<int>(currentLevel->GetObjects().size()), levelUpdateMs);
+        App::Print(10, 90, debugBuffer);
+
+        const TrajectoryCache::Stats& previewStats = aimPreviewCache->GetStats();
+        sprintf_s(debugBuffer, "Preview: %.0f%% hits  %lld miss  %lld snap  %lld refine  %lld refresh",
+                  aimPreviewCache->GetHitRate() * 100.0f, previewStats.misses, previewStats.snapshots,
+                  previewStats.refinements, previewStats.refreshes);
+        App::Print(10, 110, debugBuffer);
+
+        const AimPredictor::LatencyStats& firstPath = aimPreviewCache->GetPredictor().GetFirstPathLatency();
+        const AimPredictor::LatencyStats& fullPath = aimPreviewCache->GetPredictor().GetFullPathLatency();
+        sprintf_s(debugBuffer, "Preview latency: %.2f ms first  %.2f ms full  (max %.2f)",
+                  firstPath.AverageMs(), fullPath.AverageMs(), fullPath.maxMs);
+        App::Print(10, 130, debugBuffer);
+
+        const LevelPipeline::Stats& pipelineStats = levelPipeline.GetStats();
+        sprintf_s(debugBuffer, "Next level: %s  build %.2f ms  wait %.2f ms (max %.2f)",
+                  levelPipeline.IsNextReady() ? "ready" : "building", pipelineStats.lastBuildMs,
+                  pipelineStats.lastWaitMs, pipelineStats.maxWaitMs);
+        App::Print(10, 150, debugBuffer);
+
+        const LevelGenerator::ValidationReport& validation = pipelineStats.lastValidation;
+        const char* verdict = "unsolved";
+        if (validation.attempts == 0) verdict = "cached";
+        else if (validation.solved) verdict = validation.wallsRemoved > 0 ? "repaired" : "solved";
+        else if (!validation.complete) verdict = "over budget";
+        sprintf_s(debugBuffer, "Validation: %s  %d tries  %lld shots  %.0f shots/s",
+                  verdict, validation.attempts, validation.candidates, validation.CandidatesPerSecond());
+        App::Print(10, 170, debugBuffer);
+
+        std::shared_ptr<const TemplateLibrary::TemplateSet> templates = courseTemplates.Get();
+        if (!courseTemplates.GetLastError().empty()) {
+            sprintf_s(debugBuffer, "Templates: %.80s", courseTemplates.GetLastError().c_str());
+        } else if (templates) {
+            sprintf_s(debugBuffer, "Templates: %d from file  (loaded %u times)",
+                      static_cast<int>(templates->size()), courseTemplates.GetGeneration());
+        } else {
+            sprintf_s(debugBuffer, "Templates: built-in");
+        }
+        App::Print(10, 190, debugBuffer);
+#endif
     }
 }
 
@@ -380,144 +598,58 @@ void DrawProjectionLine(float startX, float startY, float angle, float power) {
     Ball* ball = currentLevel->GetBall();
     if (!ball || !ball->IsProjectionLineEnabled()) return;
     
-    const int MAX_BOUNCES = 5;  
-    const int STEPS_PER_BOUNCE = 15;  
-    const float BOUNCE_DAMPENING = 0.8f;
-    const float BALL_RADIUS = 6.0f;
-    const float ENEMY_FORCE_MULTIPLIER = 1.2f;
     const float DOT_LENGTH = 5.0f;  
     const float DOT_SPACING = 20.0f; 
     const float ARROW_SIZE = 15.0f;  
     
-    float normalizedPower = power / MAX_POWER;
-    float velocityX = cos(angle) * normalizedPower * MAX_POWER * 3.5f;
-    float velocityY = sin(angle) * normalizedPower * MAX_POWER * 3.5f;
+    // Play the shot with the same integrator and collision code as Level::Update,
+    // stopping after a few bounces. Simulated off this thread; until the
+    // worker catches up this draws the newest path it has finished.
+    const ShotSimulator::ShotOutcome* preview = aimPreviewCache->Get(*currentLevel, startX, startY, power, angle);
+    if (!preview) return;
     
-    float currentX = startX;
-    float currentY = startY;
-    float timeStep = 0.016f;
+    // Light blue for ghost mode, white for normal mode
+    const float r = ball->IsPhaseMode() ? 0.5f : 1.0f;
+    const float g = ball->IsPhaseMode() ? 0.5f : 1.0f;
+    const float b = 1.0f;
     
-    float accumulatedDistance = 0.0f;
-    float lastDotX = startX;
-    float lastDotY = startY;
-    float lastValidX = startX;
-    float lastValidY = startY;
+    // The path is straight between its points (start, each bounce, end); dash along it
+    const auto& path = preview->path;
     float lastValidAngle = angle;
-    
-    const auto& objects = currentLevel->GetObjects();
-    
-    // Draw the full line if in ghost mode, otherwise check for wall collisions
-    for (int bounce = 0; bounce <= MAX_BOUNCES; bounce++) {
-        for (int step = 0; step < STEPS_PER_BOUNCE; step++) {
-            float prevX = currentX;
-            float prevY = currentY;
-            
-            currentX += velocityX * timeStep;
-            currentY += velocityY * timeStep;
-            
-            // Calculate distance moved this step
-            float dx = currentX - prevX;
-            float dy = currentY - prevY;
-            float stepDistance = sqrt(dx * dx + dy * dy);
-            accumulatedDistance += stepDistance;
-            
-            // Draw dots when we've moved far enough
-            while (accumulatedDistance >= DOT_SPACING) {
-                float t = DOT_SPACING / accumulatedDistance;
-                float dotX = prevX + dx * t;
-                float dotY = prevY + dy * t;
-                
-                float dotAngle = atan2(dy, dx);
-                float dotEndX = dotX + cos(dotAngle) * DOT_LENGTH;
-                float dotEndY = dotY + sin(dotAngle) * DOT_LENGTH;
-                
-                // Use different colors for ghost mode
-                if (ball->IsPhaseMode()) {
-                    App::DrawLine(dotX, dotY, dotEndX, dotEndY, 0.5f, 0.5f, 1.0f);  // Light blue for ghost mode
-                } else {
-                    App::DrawLine(dotX, dotY, dotEndX, dotEndY, 1.0f, 1.0f, 1.0f);  // White for normal mode
-                }
-                
-                lastDotX = dotX;
-                lastDotY = dotY;
-                accumulatedDistance -= DOT_SPACING;
-            }
-            
-            bool collision = false;
-            
-            // Check level boundaries
-            if (currentX - BALL_RADIUS < 0) {
-                currentX = BALL_RADIUS;
-                velocityX = -velocityX * BOUNCE_DAMPENING;
-                collision = true;
-            }
-            else if (currentX + BALL_RADIUS > SCREEN_WIDTH) {
-                currentX = SCREEN_WIDTH - BALL_RADIUS;
-                velocityX = -velocityX * BOUNCE_DAMPENING;
-                collision = true;
-            }
-            
-            if (currentY - BALL_RADIUS < 0) {
-                currentY = BALL_RADIUS;
-                velocityY = -velocityY * BOUNCE_DAMPENING;
-                collision = true;
-            }
-            else if (currentY + BALL_RADIUS > SCREEN_HEIGHT) {
-                currentY = SCREEN_HEIGHT - BALL_RADIUS;
-                velocityY = -velocityY * BOUNCE_DAMPENING;
-                collision = true;
-            }
-            
-            // Only check wall collisions if NOT in ghost mode
-            if (!ball->IsPhaseMode()) {
-                for (const auto& obj : objects) {
-                    if (const Wall* wall = dynamic_cast<const Wall*>(obj.get())) {
-                        float wallLeft = wall->GetPosition().x - wall->GetWidth()/2;
-                        float wallRight = wall->GetPosition().x + wall->GetWidth()/2;
-                        float wallTop = wall->GetPosition().y - wall->GetHeight()/2;
-                        float wallBottom = wall->GetPosition().y + wall->GetHeight()/2;
-                        
-                        if (currentX + BALL_RADIUS > wallLeft && currentX - BALL_RADIUS < wallRight &&
-                            currentY + BALL_RADIUS > wallTop && currentY - BALL_RADIUS < wallBottom) {
-                            
-                            float rightPen = (currentX + BALL_RADIUS) - wallLeft;
-                            float leftPen = wallRight - (currentX - BALL_RADIUS);
-                            float bottomPen = (currentY + BALL_RADIUS) - wallTop;
-                            float topPen = wallBottom - (currentY - BALL_RADIUS);
-                            
-                            float minPenX = (rightPen < leftPen) ? -rightPen : leftPen;
-                            float minPenY = (bottomPen < topPen) ? -bottomPen : topPen;
-                            
-                            if (abs(minPenX) < abs(minPenY)) {
-                                velocityX = -velocityX * BOUNCE_DAMPENING;
-                                currentX = prevX;
-                            } else {
-                                velocityY = -velocityY * BOUNCE_DAMPENING;
-                                currentY = prevY;
-                            }
-                            collision = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            
-            // Update last valid position and angle
-            lastValidX = currentX;
-            lastValidY = currentY;
-            lastValidAngle = atan2(velocityY, velocityX);
-            
-            if (collision && !ball->IsPhaseMode()) {
-                break;
-            }
+    float nextDot = DOT_SPACING;
+    for (size_t i = 1; i < path.size(); i++) {
+        float dx = path[i].x - path[i - 1].x;
+        float dy = path[i].y - path[i - 1].y;
+        float length = sqrtf(dx * dx + dy * dy);
+        if (length < 0.001f) continue;
+        
+        float dirX = dx / length;
+        float dirY = dy / length;
+        for (; nextDot <= length; nextDot += DOT_SPACING) {
+            float dotX = path[i - 1].x + dirX * nextDot;
+            float dotY = path[i - 1].y + dirY * nextDot;
+            App::DrawLine(dotX, dotY, dotX + dirX * DOT_LENGTH, dotY + dirY * DOT_LENGTH, r, g, b);
         }
+        nextDot -= length;
+        lastValidAngle = atan2f(dirY, dirX);
     }
     
-    // Draw final arrow with appropriate color
-    if (ball->IsPhaseMode()) {
-        DrawArrow(lastValidX, lastValidY, lastValidAngle, ARROW_SIZE, 0.5f, 0.5f, 1.0f);  // Light blue for ghost mode
-    } else {
-        DrawArrow(lastValidX, lastValidY, lastValidAngle, ARROW_SIZE, 1.0f, 1.0f, 1.0f);  // White for normal mode
+    const float endX = path.empty() ? startX : path.back().x;
+    const float endY = path.empty() ? startY : path.back().y;
+    DrawArrow(endX, endY, lastValidAngle, ARROW_SIZE, r, g, b);
+    
+    // Mark each predicted enemy deflection: the enemy where it will be, in orange
+    const float ENEMY_MARK_RADIUS = 12.0f;
+    const int ENEMY_MARK_SEGMENTS = 12;
+    for (const auto& contact : preview->enemyContacts) {
+        for (int i = 0; i < ENEMY_MARK_SEGMENTS; i++) {
+            float a0 = 2.0f * (float)M_PI * i / ENEMY_MARK_SEGMENTS;
+            float a1 = 2.0f * (float)M_PI * (i + 1) / ENEMY_MARK_SEGMENTS;
+            App::DrawLine(contact.enemyX + cosf(a0) * ENEMY_MARK_RADIUS, contact.enemyY + sinf(a0) * ENEMY_MARK_RADIUS,
+                          contact.enemyX + cosf(a1) * ENEMY_MARK_RADIUS, contact.enemyY + sinf(a1) * ENEMY_MARK_RADIUS,
+                          1.0f, 0.5f, 0.0f);
+        }
+        App::DrawLine(contact.enemyX, contact.enemyY, contact.ballX, contact.ballY, 1.0f, 0.5f, 0.0f);
     }
 }
 
@@ -611,21 +743,10 @@ void DrawProjectionLine(Ball* ball, float startX, float startY, float endX, floa
         float currentY = startY + normalizedY * distance * t;
         
         // Only check wall collisions if NOT in ghost mode
-        if (!ball->IsPhaseMode()) {
-            for (const auto& obj : currentLevel->GetObjects()) {
-                if (const Wall* wall = dynamic_cast<const Wall*>(obj.get())) {
-                    float wallLeft = wall->GetPosition().x - wall->GetWidth()/2;
-                    float wallRight = wall->GetPosition().x + wall->GetWidth()/2;
-                    float wallTop = wall->GetPosition().y - wall->GetHeight()/2;
-                    float wallBottom = wall->GetPosition().y + wall->GetHeight()/2;
-                    
-                    if (currentX >= wallLeft && currentX <= wallRight &&
-                        currentY >= wallTop && currentY <= wallBottom) {
-                        stopped = true;
-                        break;
-                    }
-                }
-            }
+        // A point test, so a tiny radius: the line stops where it enters a wall
+        if (!ball->IsPhaseMode() &&
+            BallPhysics::FindWallOverlaps(currentLevel->GetPhysicsWorld().wallLanes, currentX, currentY, 0.5f, nullptr, 0) > 0) {
+            stopped = true;
         }
         
         // Draw line segment with different color for ghost mode
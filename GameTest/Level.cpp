@@ -4,21 +4,37 @@
 #include "GameEventManager.h"
 #include "Enemy.h"
 #include "Collectible.h"
+#include "CollisionDispatch.h"
+#include <atomic>
 #include <cmath>
 
-Level::Level(int par) : m_par(par), m_strokes(0) {}
+namespace {
+    std::atomic<uint32_t> s_nextVersion(1);
+}
+
+Level::Level(int par) : m_par(par), m_strokes(0) {
+    m_physicsWorld.width = SCREEN_WIDTH;
+    m_physicsWorld.height = SCREEN_HEIGHT;
+    m_grid.Reset(SCREEN_WIDTH, SCREEN_HEIGHT, GRID_CELL_SIZE);
+    BumpVersion();
+}
+
+void Level::BumpVersion() {
+    m_version = s_nextVersion++;
+}
+
+void Level::Update(SimSeconds deltaTime) {
+    m_activityStats.steps++;
 
-void Level::Update(float deltaTime) {
     if (m_ball) {
-        m_ball->Update(deltaTime);
-        
-        // Check collisions with all objects
-        for (auto& obj : m_objects) {
-            if (obj) {
-                m_ball->CheckCollision(*obj);
-                obj->CheckCollision(*m_ball);
-            }
+        // The ball only wakes from ApplyForce or a contact, so a resting ball isn't ticked
+        if (m_ball->IsMoving()) {
+            m_ball->Update(deltaTime);
+            m_activityStats.ballTicks++;
         }
+
+        RebinDynamicObjects();
+        CollideBall();
         
         // Check if ball is in hole
         if (m_hole && m_ball->IsMoving()) {
@@ -31,14 +47,88 @@ void Level::Update(float deltaTime) {
         }
     }
     
-    for (auto& obj : m_objects) {
+    // Tick the active set, dropping objects that have gone to sleep
+    size_t keep = 0;
+    for (int id : m_activeIds) {
+        GameObject* obj = m_objects[id].get();
         obj->Update(deltaTime);
+        m_activityStats.objectsTicked++;
+        if (obj->NeedsUpdate()) {
+            m_activeIds[keep++] = id;
+        }
+        if (obj->IsExpired()) {
+            m_pendingRemoval.push_back(id);
+        }
     }
+    m_activeIds.resize(keep);
+    m_activityStats.objectsSleeping += static_cast<int>(m_objects.size() - m_activeIds.size());
+
+    RemoveExpiredObjects();
 }
 
-void Level::Draw() {
+void Level::CollideBall() {
+    float ballX, ballY;
+    m_ball->GetPosition(ballX, ballY);
+    float radius = m_ball->GetRadius();
+
+    // Broadphase: only objects in the cells the ball swept this tick.
+    // The extra radius of margin covers wall push-outs moving the ball.
+    float prevX = ballX;
+    float prevY = ballY;
+    bool moving = m_ball->IsMoving();
+    if (moving) {
+        m_ball->GetInterpolatedPosition(0.0f, prevX, prevY);
+    }
+    float reach = radius * 2.0f;
+    float left = std::min(prevX, ballX) - reach;
+    float top = std::min(prevY, ballY) - reach;
+    float right = std::max(prevX, ballX) + reach;
+    float bottom = std::max(prevY, ballY) + reach;
+
+    // A resting ball already checked against walls and pickups here only
+    // needs the moving objects
+    bool settled = !moving && m_ballRestKey.valid &&
+                   m_ballRestKey.x == ballX && m_ballRestKey.y == ballY &&
+                   m_ballRestKey.radius == radius && m_ballRestKey.phaseMode == m_ball->IsPhaseMode();
+
+    m_candidates.clear();
+    if (settled) {
+        m_grid.QueryDynamic(left, top, right, bottom, m_candidates);
+    } else {
+        m_grid.Query(left, top, right, bottom, m_candidates);
+    }
+
+    // Same order as a full scan, so overlapping walls resolve the same way
+    std::sort(m_candidates.begin(), m_candidates.end());
+
+    for (int id : m_candidates) {
+        auto& obj = m_objects[id];
+        if (obj) {
+            CollisionDispatch::Collide(*m_ball, *obj);
+            CollisionDispatch::Collide(*obj, *m_ball);
+            if (obj->IsExpired()) {
+                m_pendingRemoval.push_back(id);
+            }
+        }
+    }
+
+    // Only trust the check if nothing pushed or woke the ball during it
+    if (!settled && !moving) {
+        float afterX, afterY;
+        m_ball->GetPosition(afterX, afterY);
+        bool unchanged = !m_ball->IsMoving() && afterX == ballX && afterY == ballY;
+        m_ballRestKey = RestKey{ ballX, ballY, radius, m_ball->IsPhaseMode(), unchanged };
+    }
+
+    m_broadphaseStats.objects = static_cast<int>(m_objects.size());
+    m_broadphaseStats.candidates = static_cast<int>(m_candidates.size());
+    m_broadphaseStats.ticks++;
+    m_broadphaseStats.totalCandidates += m_candidates.size();
+}
+
+void Level::Draw(float alpha) {
     if (m_hole) m_hole->Draw();
-    if (m_ball) m_ball->Draw();
+    if (m_ball) m_ball->DrawInterpolated(alpha);
     
     for (auto& obj : m_objects) {
         obj->Draw();
@@ -47,6 +137,7 @@ void Level::Draw() {
 
 void Level::Reset() {
     m_strokes = 0;  // Reset level-specific stroke counter
+    m_ballRestKey.valid = false;
     if (m_ball && m_hole) {
         float startX, startY;
         m_hole->GetStartPosition(startX, startY);
@@ -56,16 +147,283 @@ void Level::Reset() {
     }
 }
 
-void Level::AddObject(std::unique_ptr<GameObject> obj) {
+ObjectHandle Level::AddObject(ObjectPtr obj) {
+    const int index = static_cast<int>(m_objects.size());
+    if (const Wall* wall = ObjectCast<Wall>(obj.get())) {
+        m_physicsWorld.AddWall(wall->GetOrientedBox());
+        m_wallIds.push_back(index);
+    }
+
     m_objects.push_back(std::move(obj));
+    InsertIntoGrid(index);
+    if (m_objects.back() && m_objects.back()->NeedsUpdate()) {
+        m_activeIds.push_back(index);
+    }
+    m_ballRestKey.valid = false;
+    BumpVersion();
+
+    // Reuse a freed slot if there is one; its generation was bumped on release
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_handleSlots.size());
+        m_handleSlots.push_back(HandleSlot{ -1, 0 });
+    }
+    m_handleSlots[slot].objectIndex = index;
+    m_objectSlots.push_back(slot);
+
+    ObjectHandle handle;
+    handle.slot = slot;
+    handle.generation = m_handleSlots[slot].generation;
+    return handle;
+}
+
+GameObject* Level::Resolve(ObjectHandle handle) const {
+    if (handle.slot >= m_handleSlots.size()) return nullptr;
+
+    const HandleSlot& slot = m_handleSlots[handle.slot];
+    if (slot.generation != handle.generation || slot.objectIndex < 0) return nullptr;
+    return m_objects[slot.objectIndex].get();
+}
+
+ObjectHandle Level::GetHandle(int objectIndex) const {
+    ObjectHandle handle;
+    if (objectIndex < 0 || objectIndex >= static_cast<int>(m_objectSlots.size())) return handle;
+
+    handle.slot = m_objectSlots[objectIndex];
+    handle.generation = m_handleSlots[handle.slot].generation;
+    return handle;
+}
+
+void Level::RemoveExpiredObjects() {
+    if (m_pendingRemoval.empty()) return;
+
+    // Highest index first, so the object swapped into a hole is never one still waiting to go
+    std::sort(m_pendingRemoval.begin(), m_pendingRemoval.end());
+    m_pendingRemoval.erase(std::unique(m_pendingRemoval.begin(), m_pendingRemoval.end()), m_pendingRemoval.end());
+
+    for (auto it = m_pendingRemoval.rbegin(); it != m_pendingRemoval.rend(); ++it) {
+        const int index = *it;
+        const int last = static_cast<int>(m_objects.size()) - 1;
+
+        UnlinkObject(index);
+        HandleSlot& removed = m_handleSlots[m_objectSlots[index]];
+        removed.objectIndex = -1;
+        removed.generation++;
+        m_freeSlots.push_back(m_objectSlots[index]);
+
+        if (index != last) {
+            RelinkObject(last, index);
+            m_objects[index] = std::move(m_objects[last]);
+            m_objectSlots[index] = m_objectSlots[last];
+            m_handleSlots[m_objectSlots[index]].objectIndex = index;
+        }
+        m_objects.pop_back();
+        m_objectSlots.pop_back();
+    }
+    m_pendingRemoval.clear();
+
+    // Renames can leave these out of order; the active set is ticked in m_objects order
+    std::sort(m_activeIds.begin(), m_activeIds.end());
+    std::sort(m_dynamicIds.begin(), m_dynamicIds.end());
+    // Enemy cells are refilled from m_dynamicIds before the next query
+    m_grid.ClearDynamic();
+    m_ballRestKey.valid = false;
+    BumpVersion();
+}
+
+void Level::UnlinkObject(int index) {
+    float left, top, right, bottom;
+    if (GetStaticBounds(index, left, top, right, bottom)) {
+        m_grid.RemoveStatic(index, left, top, right, bottom);
+    } else {
+        m_dynamicIds.erase(std::remove(m_dynamicIds.begin(), m_dynamicIds.end(), index), m_dynamicIds.end());
+    }
+    m_activeIds.erase(std::remove(m_activeIds.begin(), m_activeIds.end(), index), m_activeIds.end());
+
+    if (ObjectCast<Wall>(m_objects[index].get())) {
+        const int wall = static_cast<int>(std::find(m_wallIds.begin(), m_wallIds.end(), index) - m_wallIds.begin());
+        m_physicsWorld.RemoveWall(wall);
+        m_wallIds[wall] = m_wallIds.back();
+        m_wallIds.pop_back();
+    }
+}
+
+void Level::RelinkObject(int from, int to) {
+    float left, top, right, bottom;
+    if (GetStaticBounds(from, left, top, right, bottom)) {
+        m_grid.RenameStatic(from, to, left, top, right, bottom);
+    } else {
+        std::replace(m_dynamicIds.begin(), m_dynamicIds.end(), from, to);
+    }
+    std::replace(m_activeIds.begin(), m_activeIds.end(), from, to);
+
+    // A moved wall keeps its place in the physics world
+    if (ObjectCast<Wall>(m_objects[from].get())) {
+        std::replace(m_wallIds.begin(), m_wallIds.end(), from, to);
+    }
+}
+
+void Level::ClearObjects() {
+    for (uint32_t slot : m_objectSlots) {
+        m_handleSlots[slot].objectIndex = -1;
+        m_handleSlots[slot].generation++;
+        m_freeSlots.push_back(slot);
+    }
+    m_objectSlots.clear();
+    m_objects.clear();
+    m_pendingRemoval.clear();
+    // The level is the only owner of its arena objects, so none are left
+    m_arena.Reset();
+    RebuildPhysicsWorld();
 }
 
 void Level::SetBall(std::unique_ptr<Ball> ball) {
     m_ball = std::move(ball);
+    m_ballRestKey.valid = false;
+    BumpVersion();
+    if (m_ball) {
+        m_ball->SetPhysicsWorld(&m_physicsWorld);
+    }
 }
 
 void Level::SetHole(std::unique_ptr<Hole> hole) {
     m_hole = std::move(hole);
+    BumpVersion();
+    if (m_hole) {
+        m_physicsWorld.hole = m_hole->GetTarget();
+    } else {
+        m_physicsWorld.hole.enabled = false;
+    }
+}
+
+void Level::RebuildPhysicsWorld() {
+    m_physicsWorld.ClearWalls();
+    m_wallIds.clear();
+    m_grid.ClearStatic();
+    m_grid.ClearDynamic();
+    m_dynamicIds.clear();
+    m_activeIds.clear();
+    m_ballRestKey.valid = false;
+    BumpVersion();
+
+    for (size_t i = 0; i < m_objects.size(); i++) {
+        if (const Wall* wall = ObjectCast<Wall>(m_objects[i].get())) {
+            m_physicsWorld.AddWall(wall->GetOrientedBox());
+            m_wallIds.push_back(static_cast<int>(i));
+        }
+        InsertIntoGrid(static_cast<int>(i));
+        if (m_objects[i] && m_objects[i]->NeedsUpdate()) {
+            m_activeIds.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+bool Level::GetStaticBounds(int id, float& left, float& top, float& right, float& bottom) const {
+    const GameObject* obj = m_objects[id].get();
+    if (!obj) return false;
+
+    if (const Wall* wall = ObjectCast<Wall>(obj)) {
+        BallPhysics::WallBox bounds = wall->GetBounds();
+        left = bounds.left;
+        top = bounds.top;
+        right = bounds.right;
+        bottom = bounds.bottom;
+        return true;
+    }
+    if (const Collectible* collectible = ObjectCast<Collectible>(obj)) {
+        float x, y;
+        collectible->GetPosition(x, y);
+        float r = collectible->GetRadius();
+        left = x - r;
+        top = y - r;
+        right = x + r;
+        bottom = y + r;
+        return true;
+    }
+    return false;
+}
+
+void Level::InsertIntoGrid(int id) {
+    if (!m_objects[id]) return;
+
+    float left, top, right, bottom;
+    if (GetStaticBounds(id, left, top, right, bottom)) {
+        m_grid.InsertStatic(id, left, top, right, bottom);
+    } else {
+        // Enemies and anything else that may move; binned in RebinDynamicObjects
+        m_dynamicIds.push_back(id);
+    }
+}
+
+void Level::RebinDynamicObjects() {
+    m_grid.ClearDynamic();
+    for (int id : m_dynamicIds) {
+        const GameObject* obj = m_objects[id].get();
+        if (!obj) continue;
+
+        float x, y;
+        obj->GetPosition(x, y);
+        float r = 0.0f;
+        if (const Enemy* enemy = ObjectCast<Enemy>(obj)) {
+            r = enemy->GetSize();
+        }
+        m_grid.InsertDynamic(id, x - r, y - r, x + r, y + r);
+    }
+}
+
+LevelSnapshot Level::CreateSnapshot() const {
+    LevelSnapshot snapshot;
+    snapshot.world = m_physicsWorld;
+    snapshot.par = m_par;
+
+    if (m_hole) {
+        m_hole->GetStartPosition(snapshot.startX, snapshot.startY);
+    }
+
+    if (m_ball) {
+        m_ball->GetPosition(snapshot.ball.x, snapshot.ball.y);
+        snapshot.ball.radius = m_ball->GetRadius();
+        snapshot.ball.speedMultiplier = m_ball->GetSpeedMultiplier();
+        snapshot.ball.phaseMode = m_ball->IsPhaseMode();
+        snapshot.ball.enemyImmune = m_ball->IsEnemyImmune();
+    }
+
+    for (const auto& obj : m_objects) {
+        if (const Enemy* enemy = ObjectCast<Enemy>(obj.get())) {
+            EnemySnapshot enemySnapshot;
+            enemySnapshot.patrol = enemy->GetPatrol();
+            enemySnapshot.angle = enemy->GetPatrolAngle();
+            enemySnapshot.time = enemy->GetPatrolTime();
+            enemy->GetPosition(enemySnapshot.x, enemySnapshot.y);
+            enemySnapshot.radius = enemy->GetSize();
+            enemySnapshot.active = enemy->IsAlive() && !enemy->IsExploding();
+            snapshot.enemies.push_back(enemySnapshot);
+        }
+        else if (const Collectible* collectible = ObjectCast<Collectible>(obj.get())) {
+            CollectibleSnapshot collectibleSnapshot;
+            collectible->GetPosition(collectibleSnapshot.x, collectibleSnapshot.y);
+            collectibleSnapshot.radius = collectible->GetRadius();
+            collectibleSnapshot.collected = collectible->IsCollected();
+            snapshot.collectibles.push_back(collectibleSnapshot);
+        }
+    }
+
+    return snapshot;
+}
+
+std::unique_ptr<Level> Level::Clone() const {
+    auto copy = std::make_unique<Level>(m_par);
+    copy->m_strokes = m_strokes;
+    if (m_hole) copy->SetHole(std::make_unique<Hole>(*m_hole));
+    if (m_ball) copy->SetBall(std::make_unique<Ball>(*m_ball));
+    for (const auto& obj : m_objects) {
+        if (obj) copy->AddCopy(*obj);
+        else copy->AddObject(nullptr);
+    }
+    return copy;
 }
 
 void Level::AddStroke() {
@@ -81,13 +439,16 @@ void Level::RandomizeObjects() {
     
     // Count existing objects
     for (const auto& obj : m_objects) {
-        if (dynamic_cast<Enemy*>(obj.get())) enemyCount++;
-        else if (dynamic_cast<Collectible*>(obj.get())) collectibleCount++;
-        else if (dynamic_cast<Wall*>(obj.get())) wallCount++;
+        switch (obj->GetType()) {
+            case GameObject::Type::Enemy: enemyCount++; break;
+            case GameObject::Type::Collectible: collectibleCount++; break;
+            case GameObject::Type::Wall: wallCount++; break;
+            default: break;
+        }
     }
     
     // Clear existing objects
-    m_objects.clear();
+    ClearObjects();
     
     // Create new LevelGenerator instance for helper functions
     LevelGenerator generator;
@@ -99,9 +460,8 @@ void Level::RandomizeObjects() {
         float width = generator.GetRandomFloat(50.0f, 150.0f);
         float height = generator.GetRandomFloat(20.0f, 100.0f);
         
-        auto wall = std::make_unique<Wall>(x, y, width, height);
         if (generator.IsPositionValid(x, y, std::sqrt(width*width + height*height) * 0.5f, m_objects)) {
-            m_objects.push_back(std::move(wall));
+            EmplaceObject<Wall>(x, y, width, height);
         }
     }
     
@@ -110,9 +470,8 @@ void Level::RandomizeObjects() {
         float x = generator.GetRandomFloat(100.0f, SCREEN_WIDTH - 100.0f);
         float y = generator.GetRandomFloat(100.0f, SCREEN_HEIGHT - 100.0f);
         
-        auto enemy = std::make_unique<Enemy>(x, y);
         if (generator.IsPositionValid(x, y, 15.0f, m_objects)) {
-            m_objects.push_back(std::move(enemy));
+            EmplaceObject<Enemy>(x, y);
         }
     }
     
@@ -121,9 +480,8 @@ void Level::RandomizeObjects() {
         float x = generator.GetRandomFloat(100.0f, SCREEN_WIDTH - 100.0f);
         float y = generator.GetRandomFloat(100.0f, SCREEN_HEIGHT - 100.0f);
         
-        auto collectible = std::make_unique<Collectible>(x, y);
         if (generator.IsPositionValid(x, y, 8.0f, m_objects)) {
-            m_objects.push_back(std::move(collectible));
+            EmplaceObject<Collectible>(x, y);
         }
     }
 }
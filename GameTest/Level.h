@@ -1,27 +1,131 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "GameObject.h"
+#include "ObjectArena.h"
 #include "Ball.h"
 #include "Hole.h"
+#include "BallPhysics.h"
+#include "LevelSnapshot.h"
+#include "SpatialGrid.h"
+
+// Refers to an object added to a Level. Stays safe to hold after the object
+// is removed: Level::Resolve then returns nullptr instead of a stale pointer.
+struct ObjectHandle {
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    uint32_t slot = INVALID_SLOT;
+    uint32_t generation = 0;
+};
 
 class Level {
 private:
-    std::vector<std::unique_ptr<GameObject>> m_objects;
+    // Holds what EmplaceObject and AddCopy build; declared first so it
+    // outlives the objects in it. ClearObjects() reuses its memory; objects
+    // removed one at a time during play keep theirs until then.
+    ObjectArena m_arena;
+    std::vector<ObjectPtr> m_objects;
     std::unique_ptr<Ball> m_ball;
     std::unique_ptr<Hole> m_hole;
     int m_par;
     int m_strokes;
 
+    // Static geometry the ball integrates against; the ball keeps a pointer to it.
+    // m_wallIds[w] is the object index of m_physicsWorld.walls[w].
+    BallPhysics::PhysicsWorld m_physicsWorld;
+    std::vector<int> m_wallIds;
+
+    // Broadphase over m_objects (ids are indices). Walls and collectibles are
+    // inserted once; enemies are re-binned every tick.
+    static constexpr float GRID_CELL_SIZE = 64.0f;
+    SpatialGrid m_grid;
+    std::vector<int> m_dynamicIds;
+    std::vector<int> m_candidates;
+
+    // Objects that still need Update(), in m_objects order
+    std::vector<int> m_activeIds;
+
+    // Handle slots. m_objectSlots[i] is the slot of m_objects[i]; a slot's
+    // generation is bumped when its object is removed.
+    struct HandleSlot {
+        int objectIndex;
+        uint32_t generation;
+    };
+    std::vector<HandleSlot> m_handleSlots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<uint32_t> m_objectSlots;
+
+    // Expired objects found this tick; removed at the end of Update
+    std::vector<int> m_pendingRemoval;
+
+    // Where the resting ball was last checked against walls and pickups.
+    // Until it moves, resizes or the level changes only enemies can touch it.
+    struct RestKey {
+        float x, y, radius;
+        bool phaseMode;
+        bool valid;
+    };
+    RestKey m_ballRestKey = { 0.0f, 0.0f, 0.0f, false, false };
+
+    // Bumped when objects, walls, the ball or the hole are added or removed.
+    // Drawn from one process-wide counter, so no two levels share a value.
+    uint32_t m_version = 0;
+
+    void BumpVersion();
+    void RebuildPhysicsWorld();
+    bool GetStaticBounds(int id, float& left, float& top, float& right, float& bottom) const;
+    void InsertIntoGrid(int id);
+    void UnlinkObject(int index);
+    void RelinkObject(int from, int to);
+    void RebinDynamicObjects();
+    void CollideBall();
+    void RemoveExpiredObjects();
+    void ClearObjects();
+
+public:
+    struct BroadphaseStats {
+        int objects;            // Objects in the level last tick
+        int candidates;         // Objects that reached narrow phase last tick
+        long long ticks;        // Totals since ResetBroadphaseStats()
+        long long totalCandidates;
+    };
+
+    // Accumulated over the Update() calls since BeginFrame()
+    struct ActivityStats {
+        int steps;
+        int objectsTicked;      // Update() calls on level objects
+        int objectsSleeping;    // Objects skipped, summed over steps
+        int ballTicks;          // Steps the ball was awake for
+    };
+
+private:
+    BroadphaseStats m_broadphaseStats = { 0, 0, 0, 0 };
+    ActivityStats m_activityStats = { 0, 0, 0, 0 };
+
 public:
     Level(int par);
     ~Level() = default;
 
-    void Update(float deltaTime);
-    void Draw();
+    void BeginFrame() { m_activityStats = ActivityStats{ 0, 0, 0, 0 }; }
+    void Update(SimSeconds deltaTime);
+    // alpha: how far the clock is into the next fixed step (FixedStepClock::GetAlpha)
+    void Draw(float alpha = 1.0f);
     void Reset();
 
-    void AddObject(std::unique_ptr<GameObject> obj);
+    // Heap objects stay on the heap and are deleted with the level
+    ObjectHandle AddObject(ObjectPtr obj);
+    // Builds a T in the level's arena and adds it
+    template<typename T, typename... Args>
+    ObjectHandle EmplaceObject(Args&&... args) {
+        return AddObject(ObjectPtr(m_arena.Create<T>(std::forward<Args>(args)...), ObjectDeleter(true)));
+    }
+    // Adds a copy of `obj` built in the level's arena
+    ObjectHandle AddCopy(const GameObject& obj) {
+        return AddObject(ObjectPtr(obj.CloneInto(m_arena), ObjectDeleter(true)));
+    }
+    GameObject* Resolve(ObjectHandle handle) const;
+    ObjectHandle GetHandle(int objectIndex) const;
     void SetBall(std::unique_ptr<Ball> ball);
     void SetHole(std::unique_ptr<Hole> hole);
 
@@ -31,7 +135,21 @@ public:
     int GetStrokes() const { return m_strokes; }
     void AddStroke();
 
-    const std::vector<std::unique_ptr<GameObject>>& GetObjects() const { return m_objects; }
+    const std::vector<ObjectPtr>& GetObjects() const { return m_objects; }
+    const BallPhysics::PhysicsWorld& GetPhysicsWorld() const { return m_physicsWorld; }
+    const ObjectArena& GetArena() const { return m_arena; }
+    uint32_t GetVersion() const { return m_version; }
+
+    const BroadphaseStats& GetBroadphaseStats() const { return m_broadphaseStats; }
+    const ActivityStats& GetActivityStats() const { return m_activityStats; }
+    void ResetBroadphaseStats() { m_broadphaseStats = BroadphaseStats{ 0, 0, 0, 0 }; }
+
+    // Copies the state a shot can interact with, for ShotSimulator and worker threads
+    LevelSnapshot CreateSnapshot() const;
+
+    // Independent copy, rebuilt through SetHole/SetBall/AddCopy so the
+    // handles, broadphase and physics world belong to the copy
+    std::unique_ptr<Level> Clone() const;
 
     void RandomizeObjects();
 };
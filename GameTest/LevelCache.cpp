@@ -0,0 +1,39 @@
+#include "stdafx.h"
+#include "LevelCache.h"
+#include "LevelGenerator.h"
+
+LevelCache::LevelCache(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {
+}
+
+std::unique_ptr<Level> LevelCache::Get(LevelGenerator& generator, int levelNumber, uint32_t seed) {
+    const uint64_t key = MakeKey(levelNumber, seed);
+
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        m_stats.hits++;
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return found->second->level->Clone();
+    }
+
+    m_stats.misses++;
+    std::unique_ptr<Level> level = generator.GenerateLevel(levelNumber, seed);
+    std::unique_ptr<Level> copy = level->Clone();
+
+    if (m_entries.size() >= m_capacity) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        m_stats.evictions++;
+    }
+    m_entries.push_front(Entry{ key, std::move(copy) });
+    m_index[key] = m_entries.begin();
+    return level;
+}
+
+bool LevelCache::Contains(int levelNumber, uint32_t seed) const {
+    return m_index.find(MakeKey(levelNumber, seed)) != m_index.end();
+}
+
+void LevelCache::Clear() {
+    m_entries.clear();
+    m_index.clear();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include "Level.h"
+
+class LevelGenerator;
+
+// Least-recently-used store of freshly generated levels keyed by
+// (seed, levelNumber). Get() hands out a clone, so the cached copy stays
+// untouched by play and a retry or replay costs a copy instead of a rebuild.
+// Not thread-safe; keep it with the generator that fills it.
+class LevelCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 8;
+
+    struct Stats {
+        long long hits;
+        long long misses;
+        long long evictions;
+    };
+
+    explicit LevelCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // The level for (seed, levelNumber), generated with `generator` on a miss
+    std::unique_ptr<Level> Get(LevelGenerator& generator, int levelNumber, uint32_t seed);
+    bool Contains(int levelNumber, uint32_t seed) const;
+    void Clear();
+
+    size_t GetSize() const { return m_entries.size(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::unique_ptr<Level> level;
+    };
+
+    static uint64_t MakeKey(int levelNumber, uint32_t seed) {
+        return (static_cast<uint64_t>(seed) << 32) | static_cast<uint32_t>(levelNumber);
+    }
+
+    size_t m_capacity;
+    std::list<Entry> m_entries;     // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_index;
+    Stats m_stats = { 0, 0, 0 };
+};
@@ -0,0 +1,38 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "LevelCache.h"
+#include "LevelFile.h"
+#include "LevelGenerator.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A re-request is a hit and returns the level GenerateLevel makes; a new
+// level past capacity evicts the one used least recently, not the oldest
+SELFTEST_CASE(LevelCache_EvictsLeastRecentlyUsed) {
+    const uint32_t SEED = 1701u;
+
+    LevelGenerator generator;
+    LevelCache cache(2);
+    cache.Get(generator, 1, SEED);
+    cache.Get(generator, 2, SEED);
+    std::unique_ptr<Level> hit = cache.Get(generator, 1, SEED);
+    const LevelCache::Stats& stats = cache.GetStats();
+    SELFTEST_CHECK(context, stats.hits == 1 && stats.misses == 2);
+
+    std::vector<uint8_t> cached, generated;
+    LevelFile::EncodeLevel(*hit, cached);
+    LevelFile::EncodeLevel(*generator.GenerateLevel(1, SEED), generated);
+    SELFTEST_CHECK(context, cached == generated);
+
+    // Level 1 was used last, so level 2 makes room for level 3
+    cache.Get(generator, 3, SEED);
+    SELFTEST_CHECK(context, stats.evictions == 1 && cache.GetSize() == 2);
+    SELFTEST_CHECK(context, cache.Contains(1, SEED) && cache.Contains(3, SEED) && !cache.Contains(2, SEED));
+
+    // Same number, other seed: a different entry
+    SELFTEST_CHECK(context, !cache.Contains(1, SEED + 1));
+    cache.Get(generator, 2, SEED);
+    SELFTEST_CHECK(context, stats.misses == 4 && !cache.Contains(1, SEED));
+    context.Log("%lld hits, %lld misses, %lld evictions", stats.hits, stats.misses, stats.evictions);
+}
@@ -0,0 +1,245 @@
+#include "stdafx.h"
+#include "LevelFile.h"
+#include "Wall.h"
+#include "Enemy.h"
+#include "Collectible.h"
+#include <cstring>
+#include <fstream>
+
+namespace LevelFile {
+
+    namespace {
+        constexpr int WALL_FIELDS = 5;
+        constexpr int ENEMY_FIELDS = 5;
+        constexpr int COLLECTIBLE_FIELDS = 2;
+
+        size_t RecordSize(size_t walls, size_t enemies, size_t collectibles) {
+            size_t objects = walls + enemies + collectibles;
+            size_t size = sizeof(LevelRecord)
+                + sizeof(float) * (WALL_FIELDS * walls + ENEMY_FIELDS * enemies + COLLECTIBLE_FIELDS * collectibles)
+                + enemies       // patterns
+                + objects;      // types
+            return (size + 3) & ~static_cast<size_t>(3);
+        }
+    }
+
+    void EncodeLevel(const Level& level, std::vector<uint8_t>& out) {
+        std::vector<float> walls[WALL_FIELDS];
+        std::vector<float> enemies[ENEMY_FIELDS];
+        std::vector<float> collectibles[COLLECTIBLE_FIELDS];
+        std::vector<uint8_t> patterns;
+        std::vector<uint8_t> types;
+
+        for (const auto& obj : level.GetObjects()) {
+            if (!obj) continue;
+            float x, y;
+            obj->GetPosition(x, y);
+
+            if (const Wall* wall = ObjectCast<Wall>(obj.get())) {
+                walls[0].push_back(x);
+                walls[1].push_back(y);
+                walls[2].push_back(wall->GetWidth());
+                walls[3].push_back(wall->GetHeight());
+                walls[4].push_back(wall->GetRotation());
+            }
+            else if (const Enemy* enemy = ObjectCast<Enemy>(obj.get())) {
+                // The patrol origin; Update() moves the enemy off it
+                const EnemyPatrol& patrol = enemy->GetPatrol();
+                enemies[0].push_back(patrol.startX);
+                enemies[1].push_back(patrol.startY);
+                enemies[2].push_back(patrol.speed);
+                enemies[3].push_back(patrol.patrolRadius);
+                enemies[4].push_back(patrol.patrolDistance);
+                patterns.push_back(static_cast<uint8_t>(patrol.pattern));
+            }
+            else if (ObjectCast<Collectible>(obj.get())) {
+                collectibles[0].push_back(x);
+                collectibles[1].push_back(y);
+            }
+            else {
+                continue;
+            }
+            types.push_back(static_cast<uint8_t>(obj->GetType()));
+        }
+
+        LevelRecord record = {};
+        record.par = level.GetPar();
+        if (const Hole* hole = level.GetHole()) {
+            hole->GetStartPosition(record.startX, record.startY);
+            BallPhysics::HoleTarget target = hole->GetTarget();
+            record.holeX = target.x;
+            record.holeY = target.y;
+        }
+        record.wallCount = static_cast<uint32_t>(walls[0].size());
+        record.enemyCount = static_cast<uint32_t>(enemies[0].size());
+        record.collectibleCount = static_cast<uint32_t>(collectibles[0].size());
+        record.objectCount = static_cast<uint32_t>(types.size());
+        record.size = static_cast<uint32_t>(RecordSize(record.wallCount, record.enemyCount, record.collectibleCount));
+
+        // Zero-filled, so the padding is deterministic
+        size_t base = out.size();
+        out.resize(base + record.size, 0);
+        uint8_t* cursor = out.data() + base;
+        auto put = [&cursor](const void* source, size_t bytes) {
+            if (bytes > 0) memcpy(cursor, source, bytes);
+            cursor += bytes;
+        };
+
+        put(&record, sizeof(record));
+        for (const auto& field : walls) put(field.data(), field.size() * sizeof(float));
+        for (const auto& field : enemies) put(field.data(), field.size() * sizeof(float));
+        for (const auto& field : collectibles) put(field.data(), field.size() * sizeof(float));
+        put(patterns.data(), patterns.size());
+        put(types.data(), types.size());
+    }
+
+    bool DecodeLevel(const uint8_t* data, size_t size, LevelView& view) {
+        if (size < sizeof(LevelRecord) || reinterpret_cast<uintptr_t>(data) % alignof(float) != 0) {
+            return false;
+        }
+        const LevelRecord* record = reinterpret_cast<const LevelRecord*>(data);
+
+        // Every object takes more than a byte, so a count above `size` is
+        // corrupt; checking that first keeps RecordSize from overflowing
+        const size_t walls = record->wallCount;
+        const size_t enemies = record->enemyCount;
+        const size_t collectibles = record->collectibleCount;
+        if (walls > size || enemies > size || collectibles > size) return false;
+        if (record->objectCount != walls + enemies + collectibles) return false;
+        if (record->size > size || RecordSize(walls, enemies, collectibles) > record->size) return false;
+
+        const float* floats = reinterpret_cast<const float*>(data + sizeof(LevelRecord));
+        view.record = record;
+        view.wallX = floats;            floats += walls;
+        view.wallY = floats;            floats += walls;
+        view.wallWidth = floats;        floats += walls;
+        view.wallHeight = floats;       floats += walls;
+        view.wallRotation = floats;     floats += walls;
+        view.enemyX = floats;           floats += enemies;
+        view.enemyY = floats;           floats += enemies;
+        view.enemySpeed = floats;       floats += enemies;
+        view.enemyRadius = floats;      floats += enemies;
+        view.enemyDistance = floats;    floats += enemies;
+        view.collectibleX = floats;     floats += collectibles;
+        view.collectibleY = floats;     floats += collectibles;
+        view.enemyPattern = reinterpret_cast<const uint8_t*>(floats);
+        view.objectTypes = view.enemyPattern + enemies;
+
+        for (size_t i = 0; i < enemies; i++) {
+            if (view.enemyPattern[i] > static_cast<uint8_t>(PatrolPattern::Stationary)) return false;
+        }
+
+        // The order must account for each kind's array exactly
+        size_t seen[3] = { 0, 0, 0 };
+        for (size_t i = 0; i < record->objectCount; i++) {
+            switch (static_cast<GameObject::Type>(view.objectTypes[i])) {
+            case GameObject::Type::Wall:        seen[0]++; break;
+            case GameObject::Type::Enemy:       seen[1]++; break;
+            case GameObject::Type::Collectible: seen[2]++; break;
+            default:                            return false;
+            }
+        }
+        return seen[0] == walls && seen[1] == enemies && seen[2] == collectibles;
+    }
+
+    std::unique_ptr<Level> Instantiate(const LevelView& view) {
+        const LevelRecord& record = *view.record;
+        auto level = std::make_unique<Level>(record.par);
+        level->SetHole(std::make_unique<Hole>(record.startX, record.startY, record.holeX, record.holeY, record.par));
+        level->SetBall(std::make_unique<Ball>(record.startX, record.startY));
+
+        uint32_t wall = 0;
+        uint32_t enemy = 0;
+        uint32_t collectible = 0;
+        for (uint32_t i = 0; i < record.objectCount; i++) {
+            switch (static_cast<GameObject::Type>(view.objectTypes[i])) {
+            case GameObject::Type::Wall:
+                level->EmplaceObject<Wall>(view.wallX[wall], view.wallY[wall], view.wallWidth[wall],
+                                           view.wallHeight[wall], view.wallRotation[wall]);
+                wall++;
+                break;
+
+            case GameObject::Type::Enemy: {
+                Enemy object(view.enemyX[enemy], view.enemyY[enemy], static_cast<Enemy::Pattern>(view.enemyPattern[enemy]));
+                object.SetSpeed(view.enemySpeed[enemy]);
+                object.SetPatrolRadius(view.enemyRadius[enemy]);
+                object.SetPatrolDistance(view.enemyDistance[enemy]);
+                level->EmplaceObject<Enemy>(object);
+                enemy++;
+                break;
+            }
+
+            case GameObject::Type::Collectible:
+                level->EmplaceObject<Collectible>(view.collectibleX[collectible], view.collectibleY[collectible]);
+                collectible++;
+                break;
+
+            default:
+                break;
+            }
+        }
+        return level;
+    }
+
+    bool Save(const std::string& path, const std::vector<const Level*>& levels) {
+        std::vector<uint8_t> records;
+        std::vector<uint32_t> offsets;
+        const size_t tableEnd = sizeof(FileHeader) + levels.size() * sizeof(uint32_t);
+
+        for (const Level* level : levels) {
+            if (!level) return false;
+            if (tableEnd + records.size() > UINT32_MAX) return false;
+            offsets.push_back(static_cast<uint32_t>(tableEnd + records.size()));
+            EncodeLevel(*level, records);
+        }
+
+        FileHeader header = { MAGIC, VERSION, static_cast<uint32_t>(levels.size()), 0 };
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size());
+        return static_cast<bool>(file);
+    }
+}
+
+bool LevelPack::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path.c_str())) return false;
+
+    LevelFile::FileHeader header;
+    const size_t size = m_file.GetSize();
+    if (size < sizeof(header)) {
+        Close();
+        return false;
+    }
+    memcpy(&header, m_file.GetData(), sizeof(header));
+    if (header.magic != LevelFile::MAGIC || header.version != LevelFile::VERSION ||
+        header.levelCount > (size - sizeof(header)) / sizeof(uint32_t)) {
+        Close();
+        return false;
+    }
+
+    m_offsets = reinterpret_cast<const uint32_t*>(m_file.GetData() + sizeof(header));
+    m_levelCount = header.levelCount;
+    return true;
+}
+
+void LevelPack::Close() {
+    m_file.Close();
+    m_offsets = nullptr;
+    m_levelCount = 0;
+}
+
+bool LevelPack::GetLevel(int index, LevelFile::LevelView& view) const {
+    if (index < 0 || static_cast<uint32_t>(index) >= m_levelCount) return false;
+    const uint32_t offset = m_offsets[index];
+    if (offset >= m_file.GetSize()) return false;
+    return LevelFile::DecodeLevel(m_file.GetData() + offset, m_file.GetSize() - offset, view);
+}
+
+std::unique_ptr<Level> LevelPack::LoadLevel(int index) const {
+    LevelFile::LevelView view;
+    if (!GetLevel(index, view)) return nullptr;
+    return LevelFile::Instantiate(view);
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Level.h"
+#include "MappedFile.h"
+
+// Flat binary course files. A file is a header, a table of level offsets and
+// one record per level; each record is a fixed header followed by its
+// objects as struct-of-arrays:
+//
+//   FileHeader | uint32 offsets[levelCount] | LevelRecord ...
+//   LevelRecord | wall x,y,width,height,rotation | enemy x,y,speed,radius,distance
+//               | collectible x,y | uint8 enemy patterns | uint8 object types | pad to 4
+//
+// Everything is 4-byte aligned and little-endian, so a mapped file is read in
+// place: LevelPack hands out LevelViews pointing into the mapping and nothing
+// is copied or allocated until a level is instantiated.
+//
+// A record holds the course, not play state: enemies are stored at their
+// patrol origin with fresh clocks, and the ball on the tee.
+namespace LevelFile {
+
+    constexpr uint32_t MAGIC = 0x4C564C47;     // "GLVL"
+    constexpr uint32_t VERSION = 1;            // Bump on any layout change; older files are refused
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t levelCount;
+        uint32_t reserved;
+    };
+
+    struct LevelRecord {
+        uint32_t size;              // Bytes, this header included
+        int32_t par;
+        float startX, startY;
+        float holeX, holeY;
+        uint32_t wallCount;
+        uint32_t enemyCount;
+        uint32_t collectibleCount;
+        uint32_t objectCount;       // The three above, in Level order via objectTypes
+    };
+
+    // One level, read in place. Arrays are indexed per kind; objectTypes
+    // (GameObject::Type values) gives the order Level held them in.
+    struct LevelView {
+        const LevelRecord* record;
+        const float* wallX;
+        const float* wallY;
+        const float* wallWidth;
+        const float* wallHeight;
+        const float* wallRotation;
+        const float* enemyX;
+        const float* enemyY;
+        const float* enemySpeed;
+        const float* enemyRadius;
+        const float* enemyDistance;
+        const float* collectibleX;
+        const float* collectibleY;
+        const uint8_t* enemyPattern;
+        const uint8_t* objectTypes;
+    };
+
+    // Appends `level` to `out` as one record
+    void EncodeLevel(const Level& level, std::vector<uint8_t>& out);
+
+    // Points `view` into `data`. False if the record is truncated, its
+    // counts disagree or it holds an unknown object type or pattern.
+    bool DecodeLevel(const uint8_t* data, size_t size, LevelView& view);
+
+    // A live level equal to the one encoded: same objects in the same order
+    std::unique_ptr<Level> Instantiate(const LevelView& view);
+
+    bool Save(const std::string& path, const std::vector<const Level*>& levels);
+}
+
+// A course file mapped read-only. Levels are validated as they're fetched.
+class LevelPack {
+public:
+    // False if the file is missing, not a course file or another version
+    bool Open(const std::string& path);
+    void Close();
+
+    int GetLevelCount() const { return static_cast<int>(m_levelCount); }
+    bool GetLevel(int index, LevelFile::LevelView& view) const;
+    std::unique_ptr<Level> LoadLevel(int index) const;
+
+private:
+    MappedFile m_file;
+    const uint32_t* m_offsets = nullptr;
+    uint32_t m_levelCount = 0;
+};
@@ -0,0 +1,257 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "LevelFile.h"
+#include "LevelGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+    // Written to the working directory and removed again by each case
+    const char* const SCRATCH_PATH = "LevelFileTests.glvl";
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::vector<std::unique_ptr<Level>> GenerateCourse(int count, uint32_t seed) {
+        LevelGenerator generator(seed);
+        std::vector<std::unique_ptr<Level>> course;
+        for (int levelNumber = 0; levelNumber < count; levelNumber++) {
+            course.push_back(generator.GenerateLevel(levelNumber % 60, 900u + levelNumber));
+        }
+        return course;
+    }
+
+    std::vector<const Level*> Pointers(const std::vector<std::unique_ptr<Level>>& course) {
+        std::vector<const Level*> levels;
+        for (const auto& level : course) levels.push_back(level.get());
+        return levels;
+    }
+
+    bool WriteFile(const std::vector<uint8_t>& bytes) {
+        std::ofstream file(SCRATCH_PATH, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(file);
+    }
+
+    std::vector<uint8_t> ReadFile() {
+        std::ifstream file(SCRATCH_PATH, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // DecodeLevel wants float alignment, which a byte vector's storage has
+    std::vector<uint8_t> Encode(const Level& level) {
+        std::vector<uint8_t> bytes;
+        LevelFile::EncodeLevel(level, bytes);
+        return bytes;
+    }
+
+    // Offset of the object types within an encoded record: they're its last objectCount bytes before padding
+    size_t ObjectTypesOffset(const std::vector<uint8_t>& record) {
+        LevelFile::LevelView view;
+        LevelFile::DecodeLevel(record.data(), record.size(), view);
+        return static_cast<size_t>(view.objectTypes - record.data());
+    }
+}
+
+// Save, map, instantiate, encode again: the bytes must not change, and the
+// level must keep its par, tee, cup and every object in order
+SELFTEST_CASE(LevelFile_RoundTrip) {
+    const int LEVELS = 40;
+    std::vector<std::unique_ptr<Level>> course = GenerateCourse(LEVELS, 21u);
+    if (!SELFTEST_CHECK(context, LevelFile::Save(SCRATCH_PATH, Pointers(course)))) return;
+
+    LevelPack pack;
+    if (!SELFTEST_CHECK(context, pack.Open(SCRATCH_PATH))) return;
+    SELFTEST_CHECK(context, pack.GetLevelCount() == LEVELS);
+
+    int identical = 0;
+    int matchingObjects = 0;
+    for (int i = 0; i < pack.GetLevelCount(); i++) {
+        std::unique_ptr<Level> loaded = pack.LoadLevel(i);
+        if (!SELFTEST_CHECK(context, loaded && loaded->GetHole() && loaded->GetBall())) break;
+        identical += Encode(*loaded) == Encode(*course[i]);
+
+        const auto& original = course[i]->GetObjects();
+        const auto& copy = loaded->GetObjects();
+        bool same = original.size() == copy.size() && loaded->GetPar() == course[i]->GetPar();
+        for (size_t o = 0; same && o < original.size(); o++) {
+            float x0, y0, x1, y1;
+            original[o]->GetPosition(x0, y0);
+            copy[o]->GetPosition(x1, y1);
+            same = original[o]->GetType() == copy[o]->GetType() && x0 == x1 && y0 == y1;
+        }
+        matchingObjects += same;
+    }
+    pack.Close();
+    std::remove(SCRATCH_PATH);
+
+    context.Log("%d levels: %d re-encode identically, %d have the same objects in order", LEVELS, identical, matchingObjects);
+    SELFTEST_CHECK(context, identical == LEVELS);
+    SELFTEST_CHECK(context, matchingObjects == LEVELS);
+}
+
+// Every cut of a record short of its full size is refused, as are types and
+// patterns outside the enums and counts that disagree
+SELFTEST_CASE(LevelFile_RejectsDamagedRecords) {
+    std::vector<std::unique_ptr<Level>> course = GenerateCourse(8, 22u);
+    int truncations = 0;
+    int truncationsAccepted = 0;
+    int badTypesAccepted = 0;
+    int badPatternsAccepted = 0;
+    int badCountsAccepted = 0;
+    LevelFile::LevelView view;
+    for (const auto& level : course) {
+        std::vector<uint8_t> record = Encode(*level);
+        if (!SELFTEST_CHECK(context, LevelFile::DecodeLevel(record.data(), record.size(), view))) return;
+
+        for (size_t size = 0; size < record.size(); size++) {
+            truncations++;
+            truncationsAccepted += LevelFile::DecodeLevel(record.data(), size, view);
+        }
+
+        const size_t types = ObjectTypesOffset(record);
+        std::vector<uint8_t> badType = record;
+        badType[types] = 0xFF;
+        badTypesAccepted += LevelFile::DecodeLevel(badType.data(), badType.size(), view);
+
+        // A wall marked as an enemy leaves the per-kind counts short
+        std::vector<uint8_t> swappedType = record;
+        swappedType[types] = static_cast<uint8_t>(swappedType[types] == static_cast<uint8_t>(GameObject::Type::Wall)
+                                                  ? GameObject::Type::Enemy : GameObject::Type::Wall);
+        badTypesAccepted += LevelFile::DecodeLevel(swappedType.data(), swappedType.size(), view);
+
+        if (level->GetObjects().size() > 0) {
+            LevelFile::LevelRecord header;
+            memcpy(&header, record.data(), sizeof(header));
+            if (header.enemyCount > 0) {
+                std::vector<uint8_t> badPattern = record;
+                badPattern[types - header.enemyCount] = 0xFF;
+                badPatternsAccepted += LevelFile::DecodeLevel(badPattern.data(), badPattern.size(), view);
+            }
+
+            std::vector<uint8_t> badCount = record;
+            header.objectCount++;
+            memcpy(badCount.data(), &header, sizeof(header));
+            badCountsAccepted += LevelFile::DecodeLevel(badCount.data(), badCount.size(), view);
+
+            header.objectCount--;
+            header.wallCount = 0xFFFFFFFFu;
+            memcpy(badCount.data(), &header, sizeof(header));
+            badCountsAccepted += LevelFile::DecodeLevel(badCount.data(), badCount.size(), view);
+        }
+    }
+
+    context.Log("%d truncations (%d accepted); bad types %d, bad patterns %d, bad counts %d accepted",
+                truncations, truncationsAccepted, badTypesAccepted, badPatternsAccepted, badCountsAccepted);
+    SELFTEST_CHECK(context, truncationsAccepted == 0);
+    SELFTEST_CHECK(context, badTypesAccepted == 0);
+    SELFTEST_CHECK(context, badPatternsAccepted == 0);
+    SELFTEST_CHECK(context, badCountsAccepted == 0);
+}
+
+// Open() refuses other files and versions; a pack whose offsets or records
+// are damaged opens but won't hand those levels out
+SELFTEST_CASE(LevelFile_RejectsDamagedPacks) {
+    std::vector<std::unique_ptr<Level>> course = GenerateCourse(4, 23u);
+    if (!SELFTEST_CHECK(context, LevelFile::Save(SCRATCH_PATH, Pointers(course)))) return;
+    const std::vector<uint8_t> good = ReadFile();
+    LevelPack pack;
+
+    std::vector<uint8_t> bytes = good;
+    LevelFile::FileHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+
+    header.version = LevelFile::VERSION + 1;
+    memcpy(bytes.data(), &header, sizeof(header));
+    WriteFile(bytes);
+    SELFTEST_CHECK(context, !pack.Open(SCRATCH_PATH));
+
+    header.version = LevelFile::VERSION;
+    header.magic = 0x12345678u;
+    memcpy(bytes.data(), &header, sizeof(header));
+    WriteFile(bytes);
+    SELFTEST_CHECK(context, !pack.Open(SCRATCH_PATH));
+
+    // More levels than the offset table has room for
+    header.magic = LevelFile::MAGIC;
+    header.levelCount = static_cast<uint32_t>(bytes.size());
+    memcpy(bytes.data(), &header, sizeof(header));
+    WriteFile(bytes);
+    SELFTEST_CHECK(context, !pack.Open(SCRATCH_PATH));
+
+    bytes.assign(good.begin(), good.begin() + sizeof(header) - 1);
+    WriteFile(bytes);
+    SELFTEST_CHECK(context, !pack.Open(SCRATCH_PATH));
+
+    // Offsets past the end, off alignment, and a pack cut off mid-record
+    bytes = good;
+    const uint32_t offsets[] = { static_cast<uint32_t>(good.size()), 0xFFFFFFF0u, 17u };
+    memcpy(bytes.data() + sizeof(header), offsets, sizeof(offsets));
+    WriteFile(bytes);
+    if (SELFTEST_CHECK(context, pack.Open(SCRATCH_PATH))) {
+        SELFTEST_CHECK(context, !pack.LoadLevel(0) && !pack.LoadLevel(1) && !pack.LoadLevel(2));
+        SELFTEST_CHECK(context, pack.LoadLevel(3) != nullptr);
+        SELFTEST_CHECK(context, !pack.LoadLevel(-1) && !pack.LoadLevel(4));
+        pack.Close();
+    }
+
+    bytes.assign(good.begin(), good.end() - 8);
+    WriteFile(bytes);
+    if (SELFTEST_CHECK(context, pack.Open(SCRATCH_PATH))) {
+        SELFTEST_CHECK(context, pack.LoadLevel(0) != nullptr);
+        SELFTEST_CHECK(context, !pack.LoadLevel(3));
+        pack.Close();
+    }
+    std::remove(SCRATCH_PATH);
+}
+
+// The 10k-level file from the change that added LevelFile: save, open,
+// view every level in place, then build every level
+SELFTEST_BENCHMARK(LevelFile_TenThousandLevels) {
+    const int LEVELS = 10000;
+    std::vector<std::unique_ptr<Level>> course = GenerateCourse(LEVELS, 24u);
+
+    auto start = std::chrono::steady_clock::now();
+    const bool saved = LevelFile::Save(SCRATCH_PATH, Pointers(course));
+    const double saveMs = MillisecondsSince(start);
+    if (!SELFTEST_CHECK(context, saved)) return;
+
+    LevelPack pack;
+    start = std::chrono::steady_clock::now();
+    const bool opened = pack.Open(SCRATCH_PATH);
+    const double openMs = MillisecondsSince(start);
+    if (!SELFTEST_CHECK(context, opened && pack.GetLevelCount() == LEVELS)) return;
+
+    int viewed = 0;
+    long long objects = 0;
+    LevelFile::LevelView view;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LEVELS; i++) {
+        if (!pack.GetLevel(i, view)) continue;
+        viewed++;
+        objects += view.record->objectCount;
+    }
+    const double viewMs = MillisecondsSince(start);
+
+    int built = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LEVELS; i++) {
+        built += pack.LoadLevel(i) != nullptr;
+    }
+    const double buildMs = MillisecondsSince(start);
+
+    const size_t bytes = ReadFile().size();
+    pack.Close();
+    std::remove(SCRATCH_PATH);
+
+    context.Log("%d levels, %.1f objects/level, %.1f MB: save %.1f ms, open %.3f ms",
+                LEVELS, objects / double(LEVELS), bytes / (1024.0 * 1024.0), saveMs, openMs);
+    context.Log("view %.0f ns/level, instantiate %.2f us/level",
+                viewMs * 1.0e6 / LEVELS, buildMs * 1000.0 / LEVELS);
+    SELFTEST_CHECK(context, viewed == LEVELS);
+    SELFTEST_CHECK(context, built == LEVELS);
+}
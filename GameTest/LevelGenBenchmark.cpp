@@ -0,0 +1,160 @@
+#include "stdafx.h"
+#include "LevelGenBenchmark.h"
+#include "CourseTemplates.h"
+#include "TemplateLibrary.h"
+#include "AllocationCounter.h"
+#include "Wall.h"
+#include "Enemy.h"
+#include "Collectible.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+
+namespace LevelGenBenchmark {
+
+    namespace {
+        void CountObjects(const Level& level, Metrics& metrics) {
+            int objects = 0;
+            for (const auto& obj : level.GetObjects()) {
+                if (!obj) continue;
+                objects++;
+                if (ObjectCast<Wall>(obj.get())) metrics.walls++;
+                else if (ObjectCast<Enemy>(obj.get())) metrics.enemies++;
+                else if (ObjectCast<Collectible>(obj.get())) metrics.collectibles++;
+            }
+            metrics.minObjects = metrics.levels == 0 ? objects : std::min(metrics.minObjects, objects);
+            metrics.maxObjects = std::max(metrics.maxObjects, objects);
+        }
+
+        Metrics RunCase(LevelGenerator& generator, const Options& options, int levelNumber) {
+            Metrics metrics;
+            AllocationCounter allocations;
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < options.levelsPerCase; i++) {
+                std::unique_ptr<Level> level = generator.GenerateLevel(levelNumber, options.seed + static_cast<uint32_t>(i));
+                if (!level) continue;
+
+                const LevelGenerator::GenerationReport& report = generator.GetLastGeneration();
+                metrics.positionChecks += report.positionChecks;
+                metrics.positionRejections += report.positionRejections;
+                metrics.holeAttempts += report.holeAttempts;
+                metrics.holeFallbacks += report.holeFallbacks;
+                CountObjects(*level, metrics);
+                metrics.levels++;
+            }
+
+            // Counting and freeing the levels is inside the timing too; both
+            // are small next to generation and it keeps the loop simple
+            metrics.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            metrics.allocations = allocations.Get();
+            metrics.invalidHolePlacements = generator.TakeDeferredInvalidHolePlacements();
+            return metrics;
+        }
+
+        void Append(std::string& out, const char* format, ...) {
+            char buffer[256];
+            va_list args;
+            va_start(args, format);
+            vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+            out += buffer;
+        }
+
+        void AppendMetrics(std::string& out, const Metrics& metrics) {
+            const double levels = std::max(metrics.levels, 1);
+            Append(out, "\"levels\": %d, \"elapsedMs\": %.3f, \"levelsPerSecond\": %.1f, ",
+                   metrics.levels, metrics.elapsedMs, metrics.LevelsPerSecond());
+            Append(out, "\"allocationsPerLevel\": %.2f, ", metrics.allocations / levels);
+            Append(out, "\"positionChecksPerLevel\": %.2f, \"positionRejectionRate\": %.4f, ",
+                   metrics.positionChecks / levels, metrics.RejectionRate());
+            Append(out, "\"holeRetriesPerLevel\": %.3f, \"holeFallbacks\": %lld, \"invalidHolePlacements\": %lld, ",
+                   (metrics.holeAttempts - metrics.levels) / levels, metrics.holeFallbacks, metrics.invalidHolePlacements);
+            Append(out, "\"wallsPerLevel\": %.2f, \"enemiesPerLevel\": %.2f, \"collectiblesPerLevel\": %.2f, ",
+                   metrics.walls / levels, metrics.enemies / levels, metrics.collectibles / levels);
+            Append(out, "\"minObjects\": %d, \"maxObjects\": %d", metrics.minObjects, metrics.maxObjects);
+        }
+    }
+
+    void Metrics::Add(const Metrics& other) {
+        if (other.levels == 0) return;
+        minObjects = levels == 0 ? other.minObjects : std::min(minObjects, other.minObjects);
+        maxObjects = std::max(maxObjects, other.maxObjects);
+        levels += other.levels;
+        elapsedMs += other.elapsedMs;
+        allocations += other.allocations;
+        positionChecks += other.positionChecks;
+        positionRejections += other.positionRejections;
+        holeAttempts += other.holeAttempts;
+        holeFallbacks += other.holeFallbacks;
+        invalidHolePlacements += other.invalidHolePlacements;
+        walls += other.walls;
+        enemies += other.enemies;
+        collectibles += other.collectibles;
+    }
+
+    Result Run(const Options& options) {
+        Result result;
+        result.options = options;
+
+        // Same rule as GenerateLevel for which template a level number gets
+        std::shared_ptr<const TemplateLibrary::TemplateSet> loaded = options.templates ? options.templates->Get() : nullptr;
+        result.builtInTemplates = !loaded || loaded->empty();
+        result.templateCount = result.builtInTemplates ? CourseTemplates::COUNT : static_cast<int>(loaded->size());
+        result.templates.resize(result.templateCount);
+
+        LevelGenerator generator(options.seed);
+        generator.SetDeferEvents(true);
+        generator.SetValidation(options.validation);
+        generator.SetTemplateLibrary(options.templates);
+
+        for (int levelNumber = options.firstLevel; levelNumber < options.firstLevel + options.levelCount; levelNumber++) {
+            Case entry;
+            entry.levelNumber = levelNumber;
+            entry.templateIndex = levelNumber % result.templateCount;
+            entry.metrics = RunCase(generator, options, levelNumber);
+            result.templates[entry.templateIndex].Add(entry.metrics);
+            result.total.Add(entry.metrics);
+            result.cases.push_back(entry);
+        }
+        return result;
+    }
+
+    std::string ToJson(const Result& result) {
+        const Options& options = result.options;
+        std::string out = "{\n";
+        Append(out, "  \"benchmark\": \"LevelGenerator\",\n");
+        Append(out, "  \"seed\": %u, \"levelsPerCase\": %d, \"firstLevel\": %d, \"levelCount\": %d,\n",
+               options.seed, options.levelsPerCase, options.firstLevel, options.levelCount);
+        Append(out, "  \"validation\": %s, \"templates\": \"%s\", \"templateCount\": %d,\n",
+               options.validation.enabled ? "true" : "false", result.builtInTemplates ? "built-in" : "file",
+               result.templateCount);
+
+        out += "  \"total\": { ";
+        AppendMetrics(out, result.total);
+        out += " },\n  \"perTemplate\": [\n";
+        for (size_t i = 0; i < result.templates.size(); i++) {
+            Append(out, "    { \"template\": %d, ", static_cast<int>(i));
+            AppendMetrics(out, result.templates[i]);
+            out += i + 1 < result.templates.size() ? " },\n" : " }\n";
+        }
+        out += "  ],\n  \"cases\": [\n";
+        for (size_t i = 0; i < result.cases.size(); i++) {
+            const Case& entry = result.cases[i];
+            Append(out, "    { \"levelNumber\": %d, \"template\": %d, ", entry.levelNumber, entry.templateIndex);
+            AppendMetrics(out, entry.metrics);
+            out += i + 1 < result.cases.size() ? " },\n" : " }\n";
+        }
+        out += "  ]\n}\n";
+        return out;
+    }
+
+    bool WriteJson(const std::string& path, const Result& result) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) return false;
+        file << ToJson(result);
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LevelGenerator.h"
+
+class TemplateLibrary;
+
+// Headless LevelGenerator benchmark: generates `levelsPerCase` levels for each
+// level number in [firstLevel, firstLevel + levelCount) from fixed seeds and
+// reports speed, allocations, placement rejections, hole retries and object
+// counts. Same options, same levels, so the JSON from two builds can be
+// diffed to catch regressions. Runs on the calling thread.
+namespace LevelGenBenchmark {
+
+    struct Options {
+        uint32_t seed = 1;              // Level i of a case uses seed + i
+        int levelsPerCase = 1000;
+        int firstLevel = 0;
+        int levelCount = 10;            // Two difficulty steps of each built-in template
+        LevelGenerator::Validation validation;  // Off by default: it dominates the time otherwise
+        const TemplateLibrary* templates = nullptr;
+    };
+
+    struct Metrics {
+        int levels = 0;
+        double elapsedMs = 0.0;
+        long long allocations = 0;      // operator new calls on the benchmark's thread
+        long long positionChecks = 0;
+        long long positionRejections = 0;
+        long long holeAttempts = 0;
+        long long holeFallbacks = 0;
+        long long invalidHolePlacements = 0;
+        long long walls = 0;
+        long long enemies = 0;
+        long long collectibles = 0;
+        int minObjects = 0;
+        int maxObjects = 0;
+
+        double LevelsPerSecond() const { return elapsedMs > 0.0 ? levels * 1000.0 / elapsedMs : 0.0; }
+        double RejectionRate() const { return positionChecks > 0 ? static_cast<double>(positionRejections) / positionChecks : 0.0; }
+        void Add(const Metrics& other);
+    };
+
+    struct Case {
+        int levelNumber;
+        int templateIndex;
+        Metrics metrics;
+    };
+
+    struct Result {
+        Options options;
+        bool builtInTemplates;
+        int templateCount;
+        std::vector<Case> cases;
+        std::vector<Metrics> templates;     // Cases summed per template index
+        Metrics total;
+    };
+
+    Result Run(const Options& options);
+
+    std::string ToJson(const Result& result);
+    bool WriteJson(const std::string& path, const Result& result);
+}
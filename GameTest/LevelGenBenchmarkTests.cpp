@@ -0,0 +1,61 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "AllocationCounter.h"
+#include "LevelGenBenchmark.h"
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+SELFTEST_CASE(AllocationCounter_CountsThisThreadOnly) {
+    const int BLOCKS = 100;
+    AllocationCounter outer;
+    long long counted = 0;
+    {
+        AllocationCounter inner;
+        std::vector<std::unique_ptr<int>> blocks;
+        blocks.reserve(BLOCKS);
+        for (int i = 0; i < BLOCKS; i++) blocks.emplace_back(new int(i));
+        counted = inner.Get();
+        SELFTEST_CHECK(context, counted == BLOCKS + 1 && *blocks.back() == BLOCKS - 1);
+
+        // Another thread's allocations belong to nobody here; starting it
+        // takes a few of ours
+        std::thread worker([] {
+            std::vector<std::unique_ptr<int>> theirs;
+            for (int i = 0; i < BLOCKS; i++) theirs.emplace_back(new int(i));
+        });
+        worker.join();
+        SELFTEST_CHECK(context, inner.Get() - counted < 10);
+        counted = inner.Get();
+    }
+    // The inner counter's allocations add to the outer one's
+    SELFTEST_CHECK(context, outer.Get() == counted);
+}
+
+// Array and nothrow forms go through the same counter as plain new
+SELFTEST_CASE(AllocationCounter_CountsEveryForm) {
+    AllocationCounter counter;
+    std::unique_ptr<int[]> array(new int[4]());
+    std::unique_ptr<int> nothrow(new (std::nothrow) int(7));
+    SELFTEST_CHECK(context, counter.Get() == 2 && array[3] == 0 && nothrow && *nothrow == 7);
+}
+
+// A short run covers every case and counts allocations whatever the build
+SELFTEST_CASE(LevelGenBenchmark_ReportsEveryCase) {
+    LevelGenBenchmark::Options options;
+    options.levelsPerCase = 20;
+    const LevelGenBenchmark::Result result = LevelGenBenchmark::Run(options);
+
+    SELFTEST_CHECK(context, static_cast<int>(result.cases.size()) == options.levelCount);
+    SELFTEST_CHECK(context, result.total.levels == options.levelCount * options.levelsPerCase);
+    for (const LevelGenBenchmark::Case& entry : result.cases) {
+        SELFTEST_CHECK(context, entry.metrics.levels == options.levelsPerCase && entry.metrics.allocations > 0);
+        // Every built-in template leaves room to move its hole
+        SELFTEST_CHECK(context, entry.metrics.holeFallbacks == 0);
+    }
+    const std::string json = LevelGenBenchmark::ToJson(result);
+    SELFTEST_CHECK(context, json.find("null") == std::string::npos);
+    context.Log("%.1f allocations/level, %.0f levels/s",
+                result.total.allocations / static_cast<double>(result.total.levels), result.total.LevelsPerSecond());
+}
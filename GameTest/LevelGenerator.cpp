@@ -4,18 +4,76 @@
 #include "Collectible.h"
 #include "Wall.h"
 #include "GameEventManager.h"
+#include "ThreadPool.h"
+#include "TemplateLibrary.h"
+#include <chrono>
 #include <random>
 #include <ctime>
+#include <cmath>
+#include <algorithm>
 
 float LevelGenerator::GetRandomFloat(float min, float max) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
     std::uniform_real_distribution<float> dis(min, max);
-    return dis(gen);
+    return dis(m_rng);
 }
 
-bool LevelGenerator::IsPositionValid(float x, float y, float radius, 
-    const std::vector<std::unique_ptr<GameObject>>& existingObjects) {
+bool LevelGenerator::IsOnGrid(float left, float top, float right, float bottom) {
+    return right >= 0.0f && left <= SCREEN_WIDTH && bottom >= 0.0f && top <= SCREEN_HEIGHT;
+}
+
+bool LevelGenerator::IsInsideGrid(float left, float top, float right, float bottom) {
+    return left >= 0.0f && right <= SCREEN_WIDTH && top >= 0.0f && bottom <= SCREEN_HEIGHT;
+}
+
+void LevelGenerator::SyncOccupancy(const std::vector<ObjectPtr>& objects) {
+    const GameObject* first = objects.empty() ? nullptr : objects.front().get();
+    bool stale = m_occupancySource != &objects || objects.size() < m_occupancyCount || first != m_occupancyFirst;
+    if (!stale && m_occupancyCount > 0) {
+        stale = objects[m_occupancyCount - 1].get() != m_occupancyLast;
+    }
+    if (stale) {
+        if (m_occupancy.GetColumns() == 0) {
+            m_occupancy.Reset(SCREEN_WIDTH, SCREEN_HEIGHT, OCCUPANCY_CELL_SIZE);
+        }
+        m_occupancy.ClearStatic();
+        m_offGrid.clear();
+        m_occupancySource = &objects;
+        m_occupancyFirst = first;
+        m_occupancyCount = 0;
+    }
+
+    // Walls by their bounds, everything else by its centre
+    for (; m_occupancyCount < objects.size(); m_occupancyCount++) {
+        const GameObject* obj = objects[m_occupancyCount].get();
+        const int id = static_cast<int>(m_occupancyCount);
+        BallPhysics::WallBox bounds;
+        if (const Wall* wall = ObjectCast<Wall>(obj)) {
+            bounds = wall->GetBounds();
+        } else {
+            obj->GetPosition(bounds.left, bounds.top);
+            bounds.right = bounds.left;
+            bounds.bottom = bounds.top;
+        }
+
+        if (IsOnGrid(bounds.left, bounds.top, bounds.right, bounds.bottom)) {
+            m_occupancy.InsertStatic(id, bounds.left, bounds.top, bounds.right, bounds.bottom);
+        } else {
+            m_offGrid.push_back(id);
+        }
+        m_occupancyLast = obj;
+    }
+}
+
+bool LevelGenerator::IsPositionValid(float x, float y, float radius,
+    const std::vector<ObjectPtr>& existingObjects) {
+    m_lastGeneration.positionChecks++;
+    if (IsPositionClear(x, y, radius, existingObjects)) return true;
+    m_lastGeneration.positionRejections++;
+    return false;
+}
+
+bool LevelGenerator::IsPositionClear(float x, float y, float radius, 
+    const std::vector<ObjectPtr>& existingObjects) {
     const float MIN_DISTANCE = 40.0f;
     const float WALL_SPAWN_SAFE_ZONE = 100.0f; // Larger safe zone for walls near spawn
     
@@ -42,27 +100,24 @@ bool LevelGenerator::IsPositionValid(float x, float y, float radius,
         }
     }
     
-    // Check distance from each existing object
-    for (const auto& obj : existingObjects) {
+    // Check distance from nearby objects only; walls are gathered and tested
+    // together with the same circle-vs-box kernel the ball uses
+    SyncOccupancy(existingObjects);
+    const float reach = radius + MIN_DISTANCE;
+    m_nearby.clear();
+    m_occupancy.Query(x - reach, y - reach, x + reach, y + reach, m_nearby);
+    if (!IsInsideGrid(x - reach, y - reach, x + reach, y + reach)) {
+        m_nearby.insert(m_nearby.end(), m_offGrid.begin(), m_offGrid.end());
+    }
+
+    m_wallLanes.Clear();
+    for (int id : m_nearby) {
+        const auto& obj = existingObjects[id];
         float objX, objY;
         obj->GetPosition(objX, objY);
         
-        // Special handling for walls
-        if (const Wall* wall = dynamic_cast<const Wall*>(obj.get())) {
-            float wallLeft = objX - wall->GetWidth()/2;
-            float wallRight = objX + wall->GetWidth()/2;
-            float wallTop = objY - wall->GetHeight()/2;
-            float wallBottom = objY + wall->GetHeight()/2;
-            
-            wallLeft -= MIN_DISTANCE;
-            wallRight += MIN_DISTANCE;
-            wallTop -= MIN_DISTANCE;
-            wallBottom += MIN_DISTANCE;
-            
-            if (x + radius > wallLeft && x - radius < wallRight &&
-                y + radius > wallTop && y - radius < wallBottom) {
-                return false;
-            }
+        if (const Wall* wall = ObjectCast<Wall>(obj.get())) {
+            m_wallLanes.Add(wall->GetOrientedBox());
         }
         else {
             float dx = x - objX;
@@ -74,6 +129,9 @@ bool LevelGenerator::IsPositionValid(float x, float y, float radius,
             }
         }
     }
+    if (BallPhysics::FindWallOverlaps(m_wallLanes, x, y, radius + MIN_DISTANCE, nullptr, 0) > 0) {
+        return false;
+    }
     
     // Check distance from hole and starting position if hole exists
     if (m_hole && IsTooCloseToHole(x, y, MIN_DISTANCE)) {
@@ -110,163 +168,65 @@ bool LevelGenerator::IsTooCloseToHole(float x, float y, float minDistance) {
     return false;
 }
 
-LevelGenerator::LevelGenerator() : m_hole(nullptr) {
-    InitializeTemplates();
+LevelGenerator::LevelGenerator() : LevelGenerator(std::random_device()()) {
 }
 
-void LevelGenerator::InitializeTemplates() {
-    // Template 1: Dense Zigzag Maze
-    CourseTemplate zigzag;
-    zigzag.startX = 0.1f;
-    zigzag.startY = 0.5f;
-    zigzag.holeX = 0.9f;
-    zigzag.holeY = 0.5f;
-    
-    // Create a denser zigzag pattern with multiple layers
-    for (float x = 0.2f; x < 0.9f; x += 0.1f) {
-        zigzag.walls.push_back({x, 0.3f, 150.0f, 20.0f, 0.0f});
-        zigzag.walls.push_back({x + 0.05f, 0.7f, 150.0f, 20.0f, 0.0f});
-    }
-    // Add vertical barriers
-    for (float x = 0.25f; x < 0.85f; x += 0.2f) {
-        zigzag.walls.push_back({x, 0.5f, 20.0f, 200.0f, 0.0f});
-    }
-    
-    // Add collectibles along the path
-    for (float x = 0.25f; x < 0.85f; x += 0.15f) {
-        zigzag.collectibles.push_back(std::make_pair(x, 0.5f));
-    }
-    
-    // Add enemies guarding the path
-    zigzag.enemies.push_back(std::make_pair(0.3f, 0.5f));
-    zigzag.enemies.push_back(std::make_pair(0.6f, 0.5f));
-    zigzag.enemies.push_back(std::make_pair(0.8f, 0.5f));
-    
-    m_courseTemplates.push_back(zigzag);
-
-    // Template 2: Spiral Maze
-    CourseTemplate spiral;
-    spiral.startX = 0.1f;
-    spiral.startY = 0.1f;
-    spiral.holeX = 0.5f;
-    spiral.holeY = 0.5f;
-    
-    // Create a tighter spiral pattern
-    float spiralSize = 600.0f;
-    for (float scale = 1.0f; scale > 0.3f; scale -= 0.2f) {
-        spiral.walls.push_back({0.5f, 0.3f * scale, spiralSize * scale, 20.0f, 0.0f});
-        spiral.walls.push_back({0.7f * scale, 0.5f, 20.0f, spiralSize * scale, 0.0f});
-        spiral.walls.push_back({0.5f, 0.7f * scale, spiralSize * scale, 20.0f, 0.0f});
-        spiral.walls.push_back({0.3f * scale, 0.5f, 20.0f, spiralSize * scale, 0.0f});
-    }
-    
-    // Add collectibles along the spiral
-    for (float scale = 0.9f; scale > 0.3f; scale -= 0.2f) {
-        spiral.collectibles.push_back(std::make_pair(0.5f + scale * 0.3f, 0.5f));
-        spiral.collectibles.push_back(std::make_pair(0.5f, 0.5f + scale * 0.3f));
-    }
-    
-    // Add enemies at strategic points
-    spiral.enemies.push_back(std::make_pair(0.5f, 0.7f));
-    spiral.enemies.push_back(std::make_pair(0.7f, 0.5f));
-    spiral.enemies.push_back(std::make_pair(0.5f, 0.3f));
-    
-    m_courseTemplates.push_back(spiral);
-
-    // Template 3: Grid Maze
-    CourseTemplate grid;
-    grid.startX = 0.1f;
-    grid.startY = 0.1f;
-    grid.holeX = 0.9f;
-    grid.holeY = 0.9f;
-    
-    // Create a dense grid pattern
-    for (float x = 0.2f; x < 0.9f; x += 0.15f) {
-        for (float y = 0.2f; y < 0.9f; y += 0.15f) {
-            if (GetRandomFloat(0.0f, 1.0f) < 0.7f) {
-                grid.walls.push_back({x, y, 100.0f, 20.0f, 0.0f});
-                grid.walls.push_back({x, y, 20.0f, 100.0f, 0.0f});
-            }
-        }
-    }
+LevelGenerator::LevelGenerator(uint32_t seed) : m_hole(nullptr), m_rng(seed) {
+}
 
-    // Add collectibles to grid
-    for (float x = 0.3f; x < 0.8f; x += 0.2f) {
-        for (float y = 0.3f; y < 0.8f; y += 0.2f) {
-            grid.collectibles.push_back(std::make_pair(x, y));
-        }
-    }
-    grid.enemies.push_back(std::make_pair(0.4f, 0.4f));
-    grid.enemies.push_back(std::make_pair(0.6f, 0.6f));
-    grid.enemies.push_back(std::make_pair(0.4f, 0.6f));
-    grid.enemies.push_back(std::make_pair(0.6f, 0.4f));
-    
-    m_courseTemplates.push_back(grid);
-
-    // Template 4: Pinball Style
-    CourseTemplate pinball;
-    pinball.startX = 0.1f;
-    pinball.startY = 0.1f;
-    pinball.holeX = 0.9f;
-    pinball.holeY = 0.9f;
-    
-    // Add circular arrangement of walls
-    for (float angle = 0; angle < 360; angle += 30) {
-        float x = 0.5f + 0.3f * cos(angle * 3.14159f / 180.0f);
-        float y = 0.5f + 0.3f * sin(angle * 3.14159f / 180.0f);
-        pinball.walls.push_back({x, y, 80.0f, 20.0f, angle});
+int LevelGenerator::TakeDeferredInvalidHolePlacements() {
+    int count = m_deferredInvalidHolePlacements;
+    m_deferredInvalidHolePlacements = 0;
+    return count;
+}
+
+CourseTemplate LevelGenerator::ExpandTemplate(const CourseTable& table) {
+    CourseTemplate templ;
+    templ.startX = table.startX;
+    templ.startY = table.startY;
+    templ.holeX = table.holeX;
+    templ.holeY = table.holeY;
+    templ.walls.assign(table.walls, table.walls + table.wallCount);
+    for (int i = 0; i < table.collectibleCount; i++) {
+        templ.collectibles.push_back(std::make_pair(table.collectibles[i].x, table.collectibles[i].y));
     }
-    // Add inner obstacles
-    for (int i = 0; i < 8; i++) {
-        float x = GetRandomFloat(0.3f, 0.7f);
-        float y = GetRandomFloat(0.3f, 0.7f);
-        pinball.walls.push_back({x, y, 60.0f, 20.0f, GetRandomFloat(0.0f, 360.0f)});
+    for (int i = 0; i < table.enemyCount; i++) {
+        templ.enemies.push_back(std::make_pair(table.enemies[i].x, table.enemies[i].y));
     }
 
-    // Add collectibles and enemies to pinball template
-    for (float angle = 0; angle < 360; angle += 45) {
-        float x = 0.5f + 0.2f * cos(angle * 3.14159f / 180.0f);
-        float y = 0.5f + 0.2f * sin(angle * 3.14159f / 180.0f);
-        pinball.collectibles.push_back({x, y});
-    }
-    pinball.enemies.push_back({0.5f, 0.3f});
-    pinball.enemies.push_back({0.3f, 0.5f});
-    pinball.enemies.push_back({0.7f, 0.5f});
-
-    m_courseTemplates.push_back(pinball);
-
-    // Template 5: Concentric Circles
-    CourseTemplate circles;
-    circles.startX = 0.1f;
-    circles.startY = 0.5f;
-    circles.holeX = 0.9f;
-    circles.holeY = 0.5f;
-    
-    // Create concentric circle pattern using short walls
-    for (float radius = 0.1f; radius < 0.4f; radius += 0.08f) {
-        for (float angle = 0; angle < 360; angle += 20) {
-            float x = 0.5f + radius * cos(angle * 3.14159f / 180.0f);
-            float y = 0.5f + radius * sin(angle * 3.14159f / 180.0f);
-            circles.walls.push_back({x, y, 40.0f, 20.0f, angle});
-        }
+    for (int i = 0; i < table.cellCount; i++) {
+        templ.cells.push_back(std::make_pair(table.cells[i].x, table.cells[i].y));
     }
+    templ.variation = table.variation;
+    return templ;
+}
 
-    // Add collectibles and enemies to circles template
-    for (float radius = 0.15f; radius < 0.35f; radius += 0.1f) {
-        for (float angle = 0; angle < 360; angle += 60) {
-            float x = 0.5f + radius * cos(angle * 3.14159f / 180.0f);
-            float y = 0.5f + radius * sin(angle * 3.14159f / 180.0f);
-            circles.collectibles.push_back({x, y});
+void LevelGenerator::RollVariation(CourseTemplate& templ) {
+    // The random part is rolled here, per level, from the level's own seed
+    switch (templ.variation) {
+    case TemplateVariation::GridWalls:
+        for (const auto& cell : templ.cells) {
+            if (GetRandomFloat(0.0f, 1.0f) < 0.7f) {
+                templ.walls.push_back({cell.first, cell.second, 100.0f, 20.0f, 0.0f});
+                templ.walls.push_back({cell.first, cell.second, 20.0f, 100.0f, 0.0f});
+            }
         }
+        break;
+    case TemplateVariation::PinballObstacles:
+        // Add inner obstacles
+        for (int i = 0; i < 8; i++) {
+            float x = GetRandomFloat(0.3f, 0.7f);
+            float y = GetRandomFloat(0.3f, 0.7f);
+            templ.walls.push_back({x, y, 60.0f, 20.0f, GetRandomFloat(0.0f, 360.0f)});
+        }
+        break;
+    case TemplateVariation::None:
+        break;
     }
-    circles.enemies.push_back({0.5f, 0.5f});
-    circles.enemies.push_back({0.3f, 0.5f});
-    circles.enemies.push_back({0.7f, 0.5f});
-
-    m_courseTemplates.push_back(circles);
 }
 
 void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& templ) {
+    ResetOccupancy();
     float levelWidth = MAX_LEVEL_WIDTH - MIN_LEVEL_WIDTH;
     float levelHeight = MAX_LEVEL_HEIGHT - MIN_LEVEL_HEIGHT;
 
@@ -276,6 +236,8 @@ void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& tem
     int maxAttempts = 50;  // Prevent infinite loops
     
     do {
+        m_lastGeneration.holeAttempts++;
+
         // Randomize hole position slightly around template position
         holeX = MIN_LEVEL_WIDTH + (templ.holeX * levelWidth + GetRandomFloat(-50.0f, 50.0f));
         holeY = MIN_LEVEL_HEIGHT + (templ.holeY * levelHeight + GetRandomFloat(-50.0f, 50.0f));
@@ -301,8 +263,12 @@ void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& tem
                 holeY + HOLE_SAFETY_MARGIN > wallTop && 
                 holeY - HOLE_SAFETY_MARGIN < wallBottom) {
                 validHolePosition = false;
-                auto& eventManager = GameEventManager::GetInstance();
-                eventManager.Emit(GameEventManager::EventType::InvalidHolePlacement);
+                if (m_deferEvents) {
+                    m_deferredInvalidHolePlacements++;
+                } else {
+                    auto& eventManager = GameEventManager::GetInstance();
+                    eventManager.Emit(GameEventManager::EventType::InvalidHolePlacement);
+                }
                 break;
             }
         }
@@ -311,6 +277,7 @@ void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& tem
     
     // If we couldn't find a valid position, use the template position without randomization
     if (!validHolePosition) {
+        m_lastGeneration.holeFallbacks++;
         holeX = MIN_LEVEL_WIDTH + (templ.holeX * levelWidth);
         holeY = MIN_LEVEL_HEIGHT + (templ.holeY * levelHeight);
     }
@@ -342,19 +309,37 @@ void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& tem
         
         // Ensure the randomized position is valid
         if (IsPositionValid(x, y, width/2, level->GetObjects())) {
-            auto wall = std::make_unique<Wall>(x, y, width, height);
-            level->AddObject(std::move(wall));
+            level->EmplaceObject<Wall>(x, y, width, height, wallTemplate.rotation);
         }
     }
 
+    if (m_scatter.enabled) {
+        // Every wall goes in first, so the scatter keeps clear of all of them
+        AddExtraWalls(level, templ);
+        ScatterItems(level, templ);
+    }
+    else {
+        PlaceTemplateItems(level, templ);
+        AddExtraWalls(level, templ);
+    }
+}
+
+void LevelGenerator::PlaceTemplateItems(Level* level, const CourseTemplate& templ) {
+    Clock::time_point start = Clock::now();
+    m_lastPlacement = PlacementReport{ 0, 0, 0, 0.0f };
+    float levelWidth = MAX_LEVEL_WIDTH - MIN_LEVEL_WIDTH;
+    float levelHeight = MAX_LEVEL_HEIGHT - MIN_LEVEL_HEIGHT;
+
     // Create collectibles from template
     for (const auto& collectiblePos : templ.collectibles) {
         float x = MIN_LEVEL_WIDTH + (collectiblePos.first * levelWidth);
         float y = MIN_LEVEL_HEIGHT + (collectiblePos.second * levelHeight);
         
-        if (IsPositionValid(x, y, 15.0f, level->GetObjects())) {
-            auto collectible = std::make_unique<Collectible>(x, y);
-            level->AddObject(std::move(collectible));
+        m_lastPlacement.requested++;
+        m_lastPlacement.candidates++;
+        if (IsPositionValid(x, y, COLLECTIBLE_CLEARANCE, level->GetObjects())) {
+            level->EmplaceObject<Collectible>(x, y);
+            m_lastPlacement.placed++;
         }
     }
 
@@ -363,23 +348,21 @@ void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& tem
         float x = MIN_LEVEL_WIDTH + (enemyPos.first * levelWidth);
         float y = MIN_LEVEL_HEIGHT + (enemyPos.second * levelHeight);
         
-        if (IsPositionValid(x, y, 20.0f, level->GetObjects())) {
-            float patternChoice = GetRandomFloat(0.0f, 1.0f);
-            std::unique_ptr<Enemy> enemy;
-            
-            if (patternChoice < 0.5f) {
-                enemy = std::make_unique<Enemy>(x, y, Enemy::Pattern::Circular);
-                enemy->SetPatrolRadius(GetRandomFloat(30.0f, 80.0f));
-            }
-            else {
-                enemy = std::make_unique<Enemy>(x, y, Enemy::Pattern::Stationary);
-            }
-            
-            enemy->SetSpeed(GetRandomFloat(50.0f, 150.0f));
-            level->AddObject(std::move(enemy));
+        m_lastPlacement.requested++;
+        m_lastPlacement.candidates++;
+        if (IsPositionValid(x, y, ENEMY_CLEARANCE, level->GetObjects())) {
+            AddEnemy(level, x, y);
+            m_lastPlacement.placed++;
         }
     }
 
+    m_lastPlacement.elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+void LevelGenerator::AddExtraWalls(Level* level, const CourseTemplate& templ) {
+    float levelWidth = MAX_LEVEL_WIDTH - MIN_LEVEL_WIDTH;
+    float levelHeight = MAX_LEVEL_HEIGHT - MIN_LEVEL_HEIGHT;
+
     // Add some random additional obstacles (25% chance per template wall)
     for (const auto& wallTemplate : templ.walls) {
         if (GetRandomFloat(0.0f, 1.0f) < 0.25f) {
@@ -389,13 +372,71 @@ void LevelGenerator::ApplyCourseTemplate(Level* level, const CourseTemplate& tem
             float height = 20.0f;
             
             if (IsPositionValid(x, y, width/2, level->GetObjects())) {
-                auto wall = std::make_unique<Wall>(x, y, width, height);
-                level->AddObject(std::move(wall));
+                level->EmplaceObject<Wall>(x, y, width, height);
             }
         }
     }
 }
 
+void LevelGenerator::AddEnemy(Level* level, float x, float y) {
+    float patternChoice = GetRandomFloat(0.0f, 1.0f);
+    Enemy enemy(x, y, patternChoice < 0.5f ? Enemy::Pattern::Circular : Enemy::Pattern::Stationary);
+    
+    if (patternChoice < 0.5f) {
+        enemy.SetPatrolRadius(GetRandomFloat(30.0f, 80.0f));
+    }
+    
+    enemy.SetSpeed(GetRandomFloat(50.0f, 150.0f));
+    // Set up first: AddObject reads its update state
+    level->EmplaceObject<Enemy>(enemy);
+}
+
+void LevelGenerator::ScatterItems(Level* level, const CourseTemplate& templ) {
+    Clock::time_point start = Clock::now();
+    m_lastPlacement = PlacementReport{ 0, 0, 0, 0.0f };
+    const float left = MIN_LEVEL_WIDTH;
+    const float top = MIN_LEVEL_HEIGHT;
+    const float right = MAX_LEVEL_WIDTH;
+    const float bottom = MAX_LEVEL_HEIGHT;
+
+    // Densities are per 100x100 px of play area
+    const float areaUnits = (right - left) * (bottom - top) / (100.0f * 100.0f);
+    const int collectibles = m_scatter.collectibleDensity > 0.0f ?
+        static_cast<int>(m_scatter.collectibleDensity * areaUnits + 0.5f) : static_cast<int>(templ.collectibles.size());
+    const int enemies = m_scatter.enemyDensity > 0.0f ?
+        static_cast<int>(m_scatter.enemyDensity * areaUnits + 0.5f) : static_cast<int>(templ.enemies.size());
+    m_lastPlacement.requested = collectibles + enemies;
+
+    // Clear of walls, the tee and the hole. Only walls are in the level yet, so
+    // one test at the larger clearance covers both kinds of item.
+    const auto& objects = level->GetObjects();
+    auto accept = [&](float x, float y) {
+        return !IsTooCloseToHole(x, y, HOLE_CLEAR_RADIUS) && IsPositionValid(x, y, ENEMY_CLEARANCE, objects);
+    };
+
+    // Fill the whole area, then draw the items from it at random: stopping
+    // early would bunch them around the first sample
+    PoissonDisk::SampleStats stats;
+    PoissonDisk::Sample(left, top, right, bottom, m_scatter.spacing, m_rng, accept, m_samples, 0,
+                        SCATTER_ATTEMPTS, &stats);
+    m_lastPlacement.candidates = stats.candidates;
+
+    const int count = std::min(collectibles + enemies, static_cast<int>(m_samples.size()));
+    for (int i = 0; i < count; i++) {
+        std::uniform_int_distribution<int> pick(i, static_cast<int>(m_samples.size()) - 1);
+        std::swap(m_samples[i], m_samples[pick(m_rng)]);
+
+        const PoissonDisk::Point& point = m_samples[i];
+        if (i < collectibles) {
+            level->EmplaceObject<Collectible>(point.x, point.y);
+        } else {
+            AddEnemy(level, point.x, point.y);
+        }
+    }
+    m_lastPlacement.placed = count;
+    m_lastPlacement.elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
 std::unique_ptr<Level> LevelGenerator::GenerateLevel(int levelNumber) {
     // Increase par based on level number (every 5 levels)
     int basePar = 3;
@@ -403,12 +444,18 @@ std::unique_ptr<Level> LevelGenerator::GenerateLevel(int levelNumber) {
     int par = basePar + parIncrease;
     
     auto level = std::make_unique<Level>(par);
+    m_lastGeneration = GenerationReport{ 0, 0, 0, 0 };
     
-    // Select template based on level number (cycling through templates)
-    int templateIndex = levelNumber % m_courseTemplates.size();
-    
-    // Get base template
-    CourseTemplate templ = m_courseTemplates[templateIndex];
+    // Select template based on level number (cycling through templates).
+    // A loaded set is held for the whole build, so a reload can't pull it away.
+    std::shared_ptr<const TemplateLibrary::TemplateSet> loaded = m_templates ? m_templates->Get() : nullptr;
+    CourseTemplate templ;
+    if (loaded && !loaded->empty()) {
+        templ = (*loaded)[levelNumber % loaded->size()];
+    } else {
+        templ = ExpandTemplate(CourseTemplates::Get(levelNumber % CourseTemplates::COUNT));
+    }
+    RollVariation(templ);
     
     // Scale difficulty based on level number
     float difficultyMultiplier = 1.0f + (levelNumber * 0.1f); // 10% harder each level
@@ -430,5 +477,118 @@ std::unique_ptr<Level> LevelGenerator::GenerateLevel(int levelNumber) {
     }
     
     ApplyCourseTemplate(level.get(), templ);
+    if (m_validation.enabled) {
+        level = ValidateLevel(std::move(level), templ);
+    }
+    return level;
+}
+
+std::unique_ptr<Level> LevelGenerator::ValidateLevel(std::unique_ptr<Level> level, const CourseTemplate& templ) {
+    ShotSearch::SearchOptions search = m_validation.search;
+    search.maxShots = level->GetPar();
+    search.budgetMs = 0.0f;
+    m_lastValidation = ValidationReport{ 0, 0, false, false, 0, 0.0f };
+
+    // The cap covers the whole stage, not each search
+    const long long maxCandidates = std::max(m_validation.maxCandidates, 1LL);
+    auto runSearch = [&](const Level& candidate) {
+        search.maxCandidates = std::max(maxCandidates - m_lastValidation.candidates, 1LL);
+        ShotSearch::SearchResult result = ShotSearch::FindSolution(candidate.CreateSnapshot(), ThreadPool::GetInstance(), search);
+        m_lastValidation.attempts++;
+        m_lastValidation.solved = result.solved;
+        m_lastValidation.complete = result.complete;
+        m_lastValidation.candidates += result.candidates;
+        m_lastValidation.elapsedMs += result.elapsedMs;
+        return result;
+    };
+
+    // Reject: another roll of the same template, from the same level stream
+    const int attempts = std::max(1, m_validation.maxAttempts);
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        if (attempt > 0) {
+            level = std::make_unique<Level>(level->GetPar());
+            ApplyCourseTemplate(level.get(), templ);
+        }
+        ShotSearch::SearchResult result = runSearch(*level);
+        if (result.solved || !result.complete) return level;
+    }
+
+    // Repair: clear the straight line from the tee to the hole
+    if (m_lastValidation.candidates >= maxCandidates) return level;
+    std::unique_ptr<Level> repaired = RemoveBlockingWalls(*level, m_lastValidation.wallsRemoved);
+    runSearch(*repaired);
+    return repaired;
+}
+
+std::unique_ptr<Level> LevelGenerator::RemoveBlockingWalls(const Level& level, int& removed) {
+    const float CLEARANCE = 15.0f;  // Beyond the ball radius
+    const Hole* hole = level.GetHole();
+    const Ball* ball = level.GetBall();
+
+    float startX, startY;
+    hole->GetStartPosition(startX, startY);
+    const BallPhysics::HoleTarget& target = level.GetPhysicsWorld().hole;
+    float dx = target.x - startX;
+    float dy = target.y - startY;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length > 0.0f) {
+        dx /= length;
+        dy /= length;
+    }
+    const float radius = (ball ? ball->GetRadius() : 10.0f) + CLEARANCE;
+
+    auto repaired = std::make_unique<Level>(level.GetPar());
+    auto holeCopy = std::make_unique<Hole>(*hole);
+    m_hole = holeCopy.get();
+    repaired->SetHole(std::move(holeCopy));
+    if (ball) repaired->SetBall(std::make_unique<Ball>(*ball));
+
+    removed = 0;
+    for (const auto& obj : level.GetObjects()) {
+        if (const Wall* wall = ObjectCast<Wall>(obj.get())) {
+            const BallPhysics::OrientedBox& box = wall->GetOrientedBox();
+            float distance, normalX, normalY;
+            if (BallPhysics::CircleOverlapsBox(box, startX, startY, radius) ||
+                BallPhysics::CircleOverlapsBox(box, target.x, target.y, radius) ||
+                BallPhysics::SweepCircleOrientedBox(startX, startY, dx, dy, length, radius, box, distance, normalX, normalY)) {
+                removed++;
+                continue;
+            }
+        }
+        repaired->AddCopy(*obj);
+    }
+    return repaired;
+}
+
+std::unique_ptr<Level> LevelGenerator::GenerateLevel(int levelNumber, uint32_t seed) {
+    std::seed_seq stream = { seed, static_cast<uint32_t>(levelNumber) };
+    m_rng.seed(stream);
+    return GenerateLevel(levelNumber);
+}
+
+std::unique_ptr<Level> LevelGenerator::GenerateCollectibleStressLevel(int count) {
+    auto level = std::make_unique<Level>(3);
+
+    const float startX = EDGE_MARGIN;
+    const float startY = SCREEN_HEIGHT * 0.5f;
+    auto hole = std::make_unique<Hole>(startX, startY, SCREEN_WIDTH - EDGE_MARGIN, startY, level->GetPar());
+    m_hole = hole.get();
+    level->SetHole(std::move(hole));
+    level->SetBall(std::make_unique<Ball>(startX, startY));
+
+    // Fill the field between tee and hole row by row, 20px apart
+    const float SPACING = 20.0f;
+    const float left = EDGE_MARGIN + 60.0f;
+    const float right = SCREEN_WIDTH - EDGE_MARGIN - 60.0f;
+    const int columns = static_cast<int>((right - left) / SPACING) + 1;
+    const int rows = (count + columns - 1) / columns;
+    const float top = startY - (rows - 1) * SPACING * 0.5f;
+
+    for (int i = 0; i < count; i++) {
+        float x = left + (i % columns) * SPACING;
+        float y = top + (i / columns) * SPACING;
+        level->EmplaceObject<Collectible>(x, y);
+    }
+
     return level;
 }
@@ -1,30 +1,80 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <random>
 #include <vector>
-#include <utility>  // for std::pair
 #include "Level.h"
+#include "CourseTemplates.h"
 #include "Hole.h"
+#include "SpatialGrid.h"
+#include "ShotSearch.h"
+#include "PoissonDisk.h"
 
-struct WallTemplate {
-    float relativeX;      // Position relative to level width (0.0 to 1.0)
-    float relativeY;      // Position relative to level height (0.0 to 1.0)
-    float width;
-    float height;
-    float rotation;       // Rotation in degrees
-};
-
-struct CourseTemplate {
-    std::vector<WallTemplate> walls;
-    std::vector<std::pair<float, float>> collectibles;  // Relative positions (x,y)
-    std::vector<std::pair<float, float>> enemies;       // Relative positions (x,y)
-    float startX;         // Relative start position (0.0 to 1.0)
-    float startY;
-    float holeX;         // Relative hole position (0.0 to 1.0)
-    float holeY;
-};
+class TemplateLibrary;
 
 class LevelGenerator {
+public:
+    // Optional check that a generated hole can be sunk within par. Layouts the
+    // search rules out are regenerated; after maxAttempts the walls blocking
+    // the tee-to-hole line are dropped. maxCandidates covers the whole stage,
+    // and a search cut short by it keeps the layout. It counts simulations,
+    // not time, so every machine accepts the same layout for a seed.
+    struct Validation {
+        bool enabled = false;
+        int maxAttempts = 3;
+        long long maxCandidates = 6000;     // Shots simulated across attempts and repair
+        // maxShots is replaced by the level's par, maxCandidates by what the
+        // stage has left; budgetMs is not used
+        ShotSearch::SearchOptions search;
+    };
+
+    struct ValidationReport {
+        int attempts;           // Layouts searched, the repaired one included
+        int wallsRemoved;       // By the repair; 0 if none was needed
+        bool solved;
+        bool complete;          // Last search finished within its budget
+        long long candidates;   // Shots simulated across all attempts
+        float elapsedMs;
+
+        float CandidatesPerSecond() const { return elapsedMs > 0.0f ? candidates * 1000.0f / elapsedMs : 0.0f; }
+    };
+
+    // Blue-noise placement of collectibles and enemies (PoissonDisk) in place
+    // of the template's fixed positions. Densities are items per 100x100 px of
+    // play area; 0 keeps the template's count.
+    struct Scatter {
+        bool enabled = false;
+        float collectibleDensity = 0.0f;
+        float enemyDensity = 0.0f;
+        float spacing = 60.0f;      // Minimum distance between any two items
+    };
+
+    // Collectible and enemy placement in the last ApplyCourseTemplate
+    struct PlacementReport {
+        int requested;
+        int placed;
+        int candidates;         // Positions tested
+        float elapsedMs;
+
+        float SuccessRate() const { return requested > 0 ? static_cast<float>(placed) / requested : 1.0f; }
+    };
+
+    // Work done by the last GenerateLevel, validation retries included
+    struct GenerationReport {
+        int positionChecks;     // IsPositionValid calls
+        int positionRejections;
+        int holeAttempts;       // Hole positions tried; each miss is an InvalidHolePlacement
+        int holeFallbacks;      // Layouts that gave up and used the template's hole position
+    };
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr float COLLECTIBLE_CLEARANCE = 15.0f;
+    static constexpr float ENEMY_CLEARANCE = 20.0f;
+    static constexpr int SCATTER_ATTEMPTS = 30;
+
     static constexpr float MIN_LEVEL_WIDTH = 150.0f;
     static constexpr float MAX_LEVEL_WIDTH = 850.0f;
     static constexpr float MIN_LEVEL_HEIGHT = 150.0f;
@@ -33,18 +83,84 @@ private:
     static constexpr float HOLE_CLEAR_RADIUS = 60.0f;
 
     Hole* m_hole;
-    std::vector<CourseTemplate> m_courseTemplates;
+    std::mt19937 m_rng;                   // Per generator, so a seed reproduces its levels
+
+    // Set when generating off the main thread: events are counted here and the
+    // owner emits them on the main thread instead
+    bool m_deferEvents = false;
+    int m_deferredInvalidHolePlacements = 0;
+
+    const TemplateLibrary* m_templates = nullptr;
+
+    Scatter m_scatter;
+    PlacementReport m_lastPlacement = { 0, 0, 0, 0.0f };
+    std::vector<PoissonDisk::Point> m_samples;
+
+    Validation m_validation;
+    ValidationReport m_lastValidation = { 0, 0, false, false, 0, 0.0f };
+    BallPhysics::WallLanes m_wallLanes;   // IsPositionValid scratch
+
+    GenerationReport m_lastGeneration = { 0, 0, 0, 0 };
+
+    // Occupancy grid over the objects IsPositionValid has been given, ids being
+    // indices into that vector. Placement only appends, so each call bins just
+    // the new tail; a different, shrunk or reshuffled vector is re-read.
+    // Objects wholly off the grid (scaled template enemies end up there) are
+    // kept aside rather than piled into the edge cells.
+    static constexpr float OCCUPANCY_CELL_SIZE = 64.0f;
+    SpatialGrid m_occupancy;
+    const std::vector<ObjectPtr>* m_occupancySource = nullptr;
+    const GameObject* m_occupancyFirst = nullptr;
+    const GameObject* m_occupancyLast = nullptr;
+    size_t m_occupancyCount = 0;
+    std::vector<int> m_offGrid;
+    std::vector<int> m_nearby;
+
+    void SyncOccupancy(const std::vector<ObjectPtr>& objects);
+    void ResetOccupancy() { m_occupancySource = nullptr; }
+    static bool IsOnGrid(float left, float top, float right, float bottom);
+    static bool IsInsideGrid(float left, float top, float right, float bottom);
+    bool IsPositionClear(float x, float y, float radius, const std::vector<ObjectPtr>& existingObjects);
     
-    CourseTemplate GetCourseTemplate(int templateIndex);
+    CourseTemplate ExpandTemplate(const CourseTable& table);
+    void RollVariation(CourseTemplate& templ);
     void ApplyCourseTemplate(Level* level, const CourseTemplate& templ);
-    void InitializeTemplates();
     bool IsTooCloseToHole(float x, float y, float minDistance);
+    void PlaceTemplateItems(Level* level, const CourseTemplate& templ);
+    void ScatterItems(Level* level, const CourseTemplate& templ);
+    void AddExtraWalls(Level* level, const CourseTemplate& templ);
+    void AddEnemy(Level* level, float x, float y);
+    std::unique_ptr<Level> ValidateLevel(std::unique_ptr<Level> level, const CourseTemplate& templ);
+    std::unique_ptr<Level> RemoveBlockingWalls(const Level& level, int& removed);
 
 public:
     LevelGenerator();
+    explicit LevelGenerator(uint32_t seed);
     std::unique_ptr<Level> GenerateLevel(int levelNumber);
+    // Deterministic: draws from a stream of its own keyed by (seed, levelNumber),
+    // so the result doesn't depend on what this generator made before
+    std::unique_ptr<Level> GenerateLevel(int levelNumber, uint32_t seed);
+
+    // Debug scene: `count` collectibles packed in a grid between the tee and the
+    // hole, for watching Level shrink as they are picked up
+    std::unique_ptr<Level> GenerateCollectibleStressLevel(int count);
     void SetHole(Hole* hole) { m_hole = hole; }
+    void SetDeferEvents(bool defer) { m_deferEvents = defer; }
+    int TakeDeferredInvalidHolePlacements();
+
+    void SetScatter(const Scatter& scatter) { m_scatter = scatter; }
+    const PlacementReport& GetLastPlacement() const { return m_lastPlacement; }
+
+    const GenerationReport& GetLastGeneration() const { return m_lastGeneration; }
+
+    void SetValidation(const Validation& validation) { m_validation = validation; }
+    // Outcome of the last GenerateLevel's validation stage, when enabled
+    const ValidationReport& GetLastValidation() const { return m_lastValidation; }
+
+    // Templates to use instead of the built-in ones while `templates` holds
+    // any; nullptr goes back to the built-ins. Not owned.
+    void SetTemplateLibrary(const TemplateLibrary* templates) { m_templates = templates; }
     
-    bool IsPositionValid(float x, float y, float radius, const std::vector<std::unique_ptr<GameObject>>& existingObjects);
+    bool IsPositionValid(float x, float y, float radius, const std::vector<ObjectPtr>& existingObjects);
     float GetRandomFloat(float min, float max);
 };
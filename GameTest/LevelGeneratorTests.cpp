@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "LevelFile.h"
+#include "LevelGenerator.h"
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Generates levels [firstLevel, firstLevel + 10) `repeats` times each and logs the cost
+    void RunDenseLevels(SelfTest::Context& context, const char* label, const LevelGenerator::Scatter& scatter) {
+        const int FIRST_LEVEL = 195;
+        const int LEVELS = 10;
+        const int REPEATS = 20;
+
+        LevelGenerator generator(15u);
+        generator.SetScatter(scatter);
+        int levels = 0;
+        long long objects = 0;
+        long long checks = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int levelNumber = FIRST_LEVEL; levelNumber < FIRST_LEVEL + LEVELS; levelNumber++) {
+            for (int repeat = 0; repeat < REPEATS; repeat++) {
+                std::unique_ptr<Level> level = generator.GenerateLevel(levelNumber, 1000u + repeat);
+                if (!level) continue;
+                levels++;
+                objects += level->GetObjects().size();
+                checks += generator.GetLastGeneration().positionChecks;
+            }
+        }
+        const double elapsedMs = MillisecondsSince(start);
+
+        context.Log("%s, levels %d-%d: %.3f ms/level, %.1f objects/level, %.1f position checks/level",
+                    label, FIRST_LEVEL, FIRST_LEVEL + LEVELS - 1, elapsedMs / levels,
+                    objects / double(levels), checks / double(levels));
+        SELFTEST_CHECK(context, levels == LEVELS * REPEATS);
+    }
+}
+
+// GenerateLevel(levelNumber, seed) depends on nothing else: the same call
+// again, after other levels or on another generator, builds the same course.
+// Validation included, which is capped by simulations rather than time.
+SELFTEST_CASE(LevelGenerator_SeededLevelsRepeat) {
+    const uint32_t SEED = 1700u;
+    const int LEVELS[] = { 0, 1, 5, 12, 40, 199 };
+
+    LevelGenerator::Validation validated;
+    validated.enabled = true;
+    validated.maxCandidates = 3000;
+    const LevelGenerator::Validation validations[] = { LevelGenerator::Validation(), validated };
+
+    for (const LevelGenerator::Validation& validation : validations) {
+        LevelGenerator generator;
+        LevelGenerator other;
+        generator.SetValidation(validation);
+        other.SetValidation(validation);
+
+        std::vector<std::vector<uint8_t>> first;
+        for (int levelNumber : LEVELS) {
+            std::unique_ptr<Level> level = generator.GenerateLevel(levelNumber, SEED);
+            if (!SELFTEST_CHECK(context, level != nullptr)) return;
+            first.emplace_back();
+            LevelFile::EncodeLevel(*level, first.back());
+        }
+
+        // Unseeded calls in between advance the generator's own stream
+        generator.GenerateLevel(3);
+        generator.GenerateLevel(3);
+
+        int repeats = 0;
+        for (size_t i = 0; i < first.size(); i++) {
+            std::vector<uint8_t> again, elsewhere;
+            LevelFile::EncodeLevel(*generator.GenerateLevel(LEVELS[i], SEED), again);
+            LevelFile::EncodeLevel(*other.GenerateLevel(LEVELS[i], SEED), elsewhere);
+            repeats += again == first[i] && elsewhere == first[i];
+        }
+        context.Log("%s: %d of %zu levels repeat", validation.enabled ? "validated" : "unvalidated",
+                    repeats, first.size());
+        SELFTEST_CHECK(context, repeats == static_cast<int>(first.size()));
+    }
+}
+
+// High level numbers carry the most template enemies; the scatter run packs
+// the play area with about as many items again in place of the template's
+SELFTEST_BENCHMARK(LevelGenerator_DenseLevelsAt200) {
+    RunDenseLevels(context, "template items", LevelGenerator::Scatter());
+
+    LevelGenerator::Scatter dense;
+    dense.enabled = true;
+    dense.collectibleDensity = 3.0f;
+    dense.enemyDensity = 1.0f;
+    dense.spacing = 20.0f;
+    RunDenseLevels(context, "scattered at 4 items per 100x100px", dense);
+}
+
+// IsPositionValid against a packed collectible field, as placement sees it
+// late in a dense level
+SELFTEST_BENCHMARK(LevelGenerator_PositionChecksOnPackedField) {
+    const int QUERIES = 20000;
+    const int counts[] = { 250, 1000, 2000 };
+    for (int count : counts) {
+        LevelGenerator generator(15u);
+        std::unique_ptr<Level> level = generator.GenerateCollectibleStressLevel(count);
+        if (!SELFTEST_CHECK(context, level != nullptr)) return;
+
+        std::mt19937 rng(16);
+        std::uniform_real_distribution<float> x(0.0f, 1024.0f);
+        std::uniform_real_distribution<float> y(0.0f, 768.0f);
+        int valid = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < QUERIES; i++) {
+            valid += generator.IsPositionValid(x(rng), y(rng), 15.0f, level->GetObjects());
+        }
+        const double elapsedMs = MillisecondsSince(start);
+
+        context.Log("%zu objects: %.3f us/query, %d of %d positions clear",
+                    level->GetObjects().size(), elapsedMs * 1000.0 / QUERIES, valid, QUERIES);
+    }
+}
@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "LevelPipeline.h"
+#include "LevelCache.h"
+#include "GameEventManager.h"
+
+LevelPipeline::LevelPipeline(const LevelGenerator::Validation& validation, const TemplateLibrary* templates)
+    : m_validation(validation), m_templates(templates) {
+    m_worker = std::thread([this] { Run(); });
+}
+
+LevelPipeline::~LevelPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+void LevelPipeline::Start(uint32_t seed) {
+    std::deque<Built> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_session++;
+        m_seed = seed;
+        m_queue.clear();
+        dropped.swap(m_ready);
+    }
+    m_stats = Stats();
+}
+
+void LevelPipeline::Cancel() {
+    std::deque<Built> dropped;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_session++;
+    m_queue.clear();
+    dropped.swap(m_ready);
+}
+
+void LevelPipeline::Enqueue(int levelNumber) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(levelNumber);
+    }
+    m_wake.notify_one();
+}
+
+void LevelPipeline::Rebuild() {
+    std::deque<Built> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Oldest first: what was built, what is being built, what is queued
+        std::deque<int> order;
+        for (const Built& built : m_ready) order.push_back(built.levelNumber);
+        if (m_building) order.push_back(m_buildingLevel);
+        order.insert(order.end(), m_queue.begin(), m_queue.end());
+        m_queue.swap(order);
+        dropped.swap(m_ready);
+        m_session++;    // Drops the build in flight when it finishes
+    }
+    m_wake.notify_one();
+}
+
+std::unique_ptr<Level> LevelPipeline::Take() {
+    Clock::time_point start = Clock::now();
+    Built built;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool waited = m_ready.empty();
+        m_built.wait(lock, [this] { return !m_ready.empty() || (m_queue.empty() && !m_building); });
+        if (m_ready.empty()) return nullptr;
+        built = std::move(m_ready.front());
+        m_ready.pop_front();
+        if (waited) m_stats.waited++;
+    }
+
+    float waitMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    m_stats.taken++;
+    if (built.cached) m_stats.cacheHits++;
+    m_stats.lastValidation = built.validation;
+    m_stats.lastBuildMs = built.buildMs;
+    m_stats.lastWaitMs = waitMs;
+    if (waitMs > m_stats.maxWaitMs) m_stats.maxWaitMs = waitMs;
+
+    // Events the generator held back on the worker
+    for (int i = 0; i < built.invalidHolePlacements; i++) {
+        GameEventManager::GetInstance().Emit(GameEventManager::EventType::InvalidHolePlacement);
+    }
+    return std::move(built.level);
+}
+
+bool LevelPipeline::IsNextReady() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_ready.empty();
+}
+
+void LevelPipeline::Run() {
+    // Worker only
+    LevelGenerator generator;
+    generator.SetDeferEvents(true);
+    generator.SetValidation(m_validation);
+    generator.SetTemplateLibrary(m_templates);
+    LevelCache cache;
+    uint32_t templateGeneration = m_templates ? m_templates->GetGeneration() : 0;
+
+    for (;;) {
+        int levelNumber;
+        uint64_t session;
+        uint32_t seed;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) return;
+            levelNumber = m_queue.front();
+            m_queue.pop_front();
+            session = m_session;
+            seed = m_seed;
+            m_building = true;
+            m_buildingLevel = levelNumber;
+        }
+
+        // Cached levels were built from the templates before a reload
+        if (m_templates && m_templates->GetGeneration() != templateGeneration) {
+            templateGeneration = m_templates->GetGeneration();
+            cache.Clear();
+        }
+
+        Clock::time_point start = Clock::now();
+        Built built;
+        built.levelNumber = levelNumber;
+        built.cached = cache.Contains(levelNumber, seed);
+        built.level = cache.Get(generator, levelNumber, seed);
+        built.invalidHolePlacements = generator.TakeDeferredInvalidHolePlacements();
+        built.validation = built.cached ? LevelGenerator::ValidationReport() : generator.GetLastValidation();
+        built.buildMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_building = false;
+            if (session == m_session) {
+                m_ready.push_back(std::move(built));
+            }
+        }
+        m_built.notify_all();
+    }
+}
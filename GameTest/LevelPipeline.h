@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "Level.h"
+#include "LevelGenerator.h"
+#include "TemplateLibrary.h"
+
+// Builds levels on a worker thread ahead of when the game needs them. Levels
+// come out in the order they were enqueued. Each is GenerateLevel(number, seed)
+// for the seed given to Start(), so a session plays exactly the levels the
+// synchronous call would make. Levels asked for again (the course repeats
+// numbers, and a restarted seed repeats them all) come from a LevelCache.
+// The optional validation stage runs on the worker too, and a TemplateLibrary,
+// if given, replaces the built-in course templates.
+class LevelPipeline {
+public:
+    // Main thread only; updated by Take()
+    struct Stats {
+        int taken;
+        int cacheHits;          // Takes served from the LevelCache
+        int waited;             // Takes that had to wait for the worker
+        float lastBuildMs;      // Worker time for the last level taken
+        float lastWaitMs;
+        float maxWaitMs;
+        LevelGenerator::ValidationReport lastValidation;   // Zeroed for cache hits
+    };
+
+    explicit LevelPipeline(const LevelGenerator::Validation& validation = LevelGenerator::Validation(),
+                           const TemplateLibrary* templates = nullptr);
+    ~LevelPipeline();
+
+    LevelPipeline(const LevelPipeline&) = delete;
+    LevelPipeline& operator=(const LevelPipeline&) = delete;
+
+    // New session on `seed`: drops anything queued or built
+    void Start(uint32_t seed);
+    void Cancel();
+
+    // Appends GenerateLevel(levelNumber) to the build order
+    void Enqueue(int levelNumber);
+
+    // Builds everything not yet taken again, in the same order; for when the
+    // templates changed under levels already built
+    void Rebuild();
+
+    // Oldest enqueued level, waiting for the worker if it isn't built yet.
+    // nullptr if nothing was enqueued.
+    std::unique_ptr<Level> Take();
+
+    bool IsNextReady() const;
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Built {
+        int levelNumber;
+        std::unique_ptr<Level> level;
+        int invalidHolePlacements;      // Deferred GameEventManager events
+        float buildMs;
+        bool cached;
+        LevelGenerator::ValidationReport validation;
+    };
+
+    void Run();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;     // Worker: work queued or stopping
+    std::condition_variable m_built;    // Take(): a level finished
+    std::deque<int> m_queue;            // Level numbers still to build
+    std::deque<Built> m_ready;
+    uint64_t m_session = 0;             // Bumped by Start()/Cancel(); stale builds are dropped
+    uint32_t m_seed = 0;
+    bool m_building = false;
+    int m_buildingLevel = 0;
+    bool m_stopping = false;
+
+    const LevelGenerator::Validation m_validation;
+    const TemplateLibrary* const m_templates;
+    Stats m_stats = {};
+
+    std::thread m_worker;               // Last, so everything above exists before it starts
+};
@@ -0,0 +1,43 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "LevelFile.h"
+#include "LevelGenerator.h"
+#include "LevelPipeline.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A session plays exactly the levels the synchronous generator makes for the
+// same seed, including numbers asked for twice (served from the cache).
+// Compared through their course-file records, which hold every object.
+SELFTEST_CASE(LevelPipeline_MatchesSynchronousGenerator) {
+    const uint32_t SEED = 1600u;
+    const int ORDER[] = { 0, 1, 2, 3, 7, 12, 2, 30, 1 };
+
+    LevelPipeline pipeline;
+    pipeline.Start(SEED);
+    for (int levelNumber : ORDER) {
+        pipeline.Enqueue(levelNumber);
+    }
+
+    LevelGenerator generator;
+    int mismatches = 0;
+    for (int levelNumber : ORDER) {
+        std::unique_ptr<Level> piped = pipeline.Take();
+        std::unique_ptr<Level> direct = generator.GenerateLevel(levelNumber, SEED);
+        if (!SELFTEST_CHECK(context, piped && direct)) return;
+
+        std::vector<uint8_t> pipedRecord, directRecord;
+        LevelFile::EncodeLevel(*piped, pipedRecord);
+        LevelFile::EncodeLevel(*direct, directRecord);
+        if (pipedRecord != directRecord) {
+            context.Log("level %d differs from GenerateLevel(%d, %u)", levelNumber, levelNumber, SEED);
+            mismatches++;
+        }
+    }
+
+    const LevelPipeline::Stats& stats = pipeline.GetStats();
+    context.Log("%d levels taken, %d from the cache, %d mismatches", stats.taken, stats.cacheHits, mismatches);
+    SELFTEST_CHECK(context, mismatches == 0);
+    SELFTEST_CHECK(context, stats.cacheHits == 2);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include "BallPhysics.h"
+#include "EnemyPatrol.h"
+
+// Plain-data copy of everything a shot can interact with. Built from a live
+// Level by Level::CreateSnapshot(); has no App/GL dependencies, so it can be
+// handed to worker threads and headless tools.
+
+struct EnemySnapshot {
+    EnemyPatrol patrol;
+    float angle;        // Patrol clocks at snapshot time
+    float time;
+    float x, y;         // Current position (before the next tick)
+    float radius;
+    bool active;        // Alive and not exploding
+
+    // Where the enemy will be `elapsed` seconds of ticks after the snapshot.
+    void PositionAt(float elapsed, float& outX, float& outY) const {
+        if (elapsed <= 0.0f) {
+            outX = x;
+            outY = y;
+            return;
+        }
+        patrol.EvaluateAhead(angle, time, elapsed, outX, outY);
+    }
+};
+
+struct CollectibleSnapshot {
+    float x, y;
+    float radius;
+    bool collected;
+};
+
+struct BallSnapshot {
+    float x, y;
+    float radius;
+    float speedMultiplier;
+    bool phaseMode;
+    bool enemyImmune;
+};
+
+struct LevelSnapshot {
+    BallPhysics::PhysicsWorld world;   // Bounds, walls and hole
+    std::vector<EnemySnapshot> enemies;
+    std::vector<CollectibleSnapshot> collectibles;
+    BallSnapshot ball = { 0.0f, 0.0f, 10.0f, 1.0f, false, false };
+    float startX = 0.0f;
+    float startY = 0.0f;
+    int par = 0;
+};
@@ -0,0 +1,54 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "Collectible.h"
+#include "Enemy.h"
+#include "Level.h"
+#include "SimClock.h"
+#include "Wall.h"
+#include <memory>
+
+namespace {
+    // Rests the ball on a pickup and runs one step, which collects and removes it
+    void CollectAt(Level& level, float x, float y) {
+        level.GetBall()->SetPosition(x, y);
+        level.GetBall()->Stop();
+        level.Update(SimSeconds(FixedStepClock::STEP_SECONDS));
+    }
+}
+
+// Removal swaps the last object into the hole. The removed object's handle
+// must go stale, the moved one's must follow it, and the broadphase must
+// still find the moved object under its new index.
+SELFTEST_CASE(Level_HandlesSurviveRemoval) {
+    Level level(3);
+    level.SetHole(std::unique_ptr<Hole>(new Hole(100.0f, 100.0f, 900.0f, 700.0f, 3)));
+    level.SetBall(std::unique_ptr<Ball>(new Ball(100.0f, 100.0f)));
+
+    const ObjectHandle wall = level.EmplaceObject<Wall>(400.0f, 600.0f, 120.0f, 20.0f);
+    const ObjectHandle first = level.EmplaceObject<Collectible>(500.0f, 400.0f);
+    const ObjectHandle enemy = level.EmplaceObject<Enemy>(250.0f, 650.0f);
+    const ObjectHandle last = level.EmplaceObject<Collectible>(700.0f, 200.0f);
+    GameObject* const wallObject = level.Resolve(wall);
+    GameObject* const enemyObject = level.Resolve(enemy);
+    GameObject* const lastObject = level.Resolve(last);
+    if (!SELFTEST_CHECK(context, level.GetObjects().size() == 4 && lastObject != nullptr)) return;
+
+    CollectAt(level, 500.0f, 400.0f);
+    SELFTEST_CHECK(context, level.GetObjects().size() == 3);
+    SELFTEST_CHECK(context, level.Resolve(first) == nullptr);
+    SELFTEST_CHECK(context, level.Resolve(last) == lastObject);
+    SELFTEST_CHECK(context, level.GetObjects()[1].get() == lastObject);
+    SELFTEST_CHECK(context, level.Resolve(wall) == wallObject && level.Resolve(enemy) == enemyObject);
+    SELFTEST_CHECK(context, level.GetPhysicsWorld().walls.size() == 1);
+
+    // Only reachable if the grid entry was renamed along with the object
+    CollectAt(level, 700.0f, 200.0f);
+    SELFTEST_CHECK(context, level.GetObjects().size() == 2);
+    SELFTEST_CHECK(context, level.Resolve(last) == nullptr);
+    SELFTEST_CHECK(context, level.Resolve(enemy) == enemyObject);
+
+    // A reused slot gets a new generation, so the old handles stay stale
+    const ObjectHandle added = level.EmplaceObject<Collectible>(600.0f, 300.0f);
+    SELFTEST_CHECK(context, level.Resolve(added) != nullptr);
+    SELFTEST_CHECK(context, level.Resolve(first) == nullptr && level.Resolve(last) == nullptr);
+}
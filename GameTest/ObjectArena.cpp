@@ -0,0 +1,47 @@
+#include "stdafx.h"
+#include "ObjectArena.h"
+#include <algorithm>
+#include <cstdint>
+
+void* ObjectArena::Allocate(GameObject::Type type, size_t size, size_t alignment) {
+    Region& region = m_regions[static_cast<int>(type)];
+
+    size_t padding = 0;
+    if (region.cursor) {
+        padding = (alignment - reinterpret_cast<uintptr_t>(region.cursor) % alignment) % alignment;
+    }
+    if (!region.cursor || padding + size > static_cast<size_t>(region.end - region.cursor)) {
+        // new[] aligns for any fundamental type, so a fresh chunk needs no padding
+        const size_t chunkSize = std::max(region.nextChunkSize, size * FIRST_CHUNK_OBJECTS);
+        region.chunks.emplace_back(new unsigned char[chunkSize]);
+        region.cursor = region.chunks.back().get();
+        region.end = region.cursor + chunkSize;
+        region.nextChunkSize = chunkSize * 2;
+        padding = 0;
+    }
+
+    void* memory = region.cursor + padding;
+    region.cursor += padding + size;
+    m_bytesUsed += size;
+    return memory;
+}
+
+void ObjectArena::Reset() {
+    for (Region& region : m_regions) {
+        if (region.chunks.empty()) continue;
+        // Chunks double, so the last one is the largest
+        std::unique_ptr<unsigned char[]> largest = std::move(region.chunks.back());
+        region.chunks.clear();
+        region.chunks.push_back(std::move(largest));
+        region.cursor = region.chunks.back().get();
+    }
+    m_bytesUsed = 0;
+}
+
+size_t ObjectArena::GetChunkCount() const {
+    size_t count = 0;
+    for (const Region& region : m_regions) {
+        count += region.chunks.size();
+    }
+    return count;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "GameObject.h"
+
+// Bump allocator holding one Level's objects. Each object type gets its own
+// run of chunks, so a level's walls sit next to each other in memory, as do
+// its enemies and its collectibles, instead of wherever the heap put them.
+// Memory is never handed back one object at a time: the arena frees all of
+// it at once when it goes, or makes it reusable on Reset(), so everything
+// built here must have been destroyed by then (ObjectDeleter does that for a
+// Level's objects).
+class ObjectArena {
+public:
+    ObjectArena() = default;
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+
+    template<typename T, typename... Args>
+    T* Create(Args&&... args) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "chunks are only aligned for fundamental types");
+        return new (Allocate(T::TYPE, sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Rewinds every type to the start of its largest chunk and frees the
+    // others, so a refill of about the same size allocates nothing. Only
+    // once every object built here has been destroyed.
+    void Reset();
+
+    size_t GetBytesUsed() const { return m_bytesUsed; }
+    size_t GetChunkCount() const;
+
+private:
+    // A type's first chunk fits this many of its objects; each later one is
+    // twice the size of the last, so even the stress level takes a few chunks
+    static constexpr size_t FIRST_CHUNK_OBJECTS = 16;
+
+    struct Region {
+        std::vector<std::unique_ptr<unsigned char[]>> chunks;
+        unsigned char* cursor = nullptr;
+        unsigned char* end = nullptr;
+        size_t nextChunkSize = 0;
+    };
+
+    void* Allocate(GameObject::Type type, size_t size, size_t alignment);
+
+    Region m_regions[static_cast<int>(GameObject::Type::Count)];
+    size_t m_bytesUsed = 0;
+};
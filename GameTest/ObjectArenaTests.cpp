@@ -0,0 +1,153 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "AllocationCounter.h"
+#include "Collectible.h"
+#include "Level.h"
+#include "LevelGenerator.h"
+#include "ObjectArena.h"
+#include "SimClock.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    // Larger than any cache here, so one pass leaves none of a level behind
+    const size_t EVICT_BYTES = 32 * 1024 * 1024;
+
+    void EvictCaches(std::vector<unsigned char>& sweep) {
+        for (size_t i = 0; i < sweep.size(); i += 64) sweep[i]++;
+    }
+
+    std::vector<ObjectPtr> Fill(ObjectArena& arena, int count) {
+        std::vector<ObjectPtr> objects;
+        objects.reserve(count);
+        for (int i = 0; i < count; i++) {
+            objects.emplace_back(arena.Create<Collectible>(float(i), 0.0f), ObjectDeleter(true));
+        }
+        return objects;
+    }
+
+    // The layout before the arena: each object its own heap block, with the
+    // rest of a long session's allocations landing between them
+    std::unique_ptr<Level> HeapCopy(const Level& level, std::mt19937& rng, std::vector<std::unique_ptr<char[]>>& noise) {
+        std::uniform_int_distribution<int> noiseSize(16, 1024);
+        auto copy = std::make_unique<Level>(level.GetPar());
+        copy->SetHole(std::make_unique<Hole>(*level.GetHole()));
+        copy->SetBall(std::make_unique<Ball>(*level.GetBall()));
+        for (const auto& obj : level.GetObjects()) {
+            for (int i = 0; i < 8; i++) noise.emplace_back(new char[noiseSize(rng)]);
+            copy->AddObject(obj->Clone());
+        }
+        return copy;
+    }
+
+    // Mean microseconds for one Update and Draw of each level, warm or with
+    // the caches emptied before every frame
+    double TimeFrames(std::vector<std::unique_ptr<Level>>& levels, int frames, std::vector<unsigned char>* sweep) {
+        double seconds = 0.0;
+        for (int frame = 0; frame < frames; frame++) {
+            for (auto& level : levels) {
+                if (sweep) EvictCaches(*sweep);
+                const auto start = std::chrono::steady_clock::now();
+                level->BeginFrame();
+                level->Update(SimSeconds(FixedStepClock::STEP_SECONDS));
+                level->Draw();
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+        return seconds * 1.0e6 / (frames * levels.size());
+    }
+}
+
+// After Reset a type keeps its largest chunk, so refilling to the same size
+// settles at no allocations at all
+SELFTEST_CASE(ObjectArena_ResetReusesChunks) {
+    const int OBJECTS = 100;
+    ObjectArena arena;
+    long long allocations[3];
+    for (int fill = 0; fill < 3; fill++) {
+        AllocationCounter counter;
+        std::vector<ObjectPtr> objects = Fill(arena, OBJECTS);
+        allocations[fill] = counter.Get();
+        SELFTEST_CHECK(context, arena.GetBytesUsed() == OBJECTS * sizeof(Collectible));
+        objects.clear();
+        arena.Reset();
+        SELFTEST_CHECK(context, arena.GetBytesUsed() == 0 && arena.GetChunkCount() == 1);
+    }
+    context.Log("allocations per fill: %lld, %lld, %lld", allocations[0], allocations[1], allocations[2]);
+    // Only the vector of pointers' block is left
+    SELFTEST_CHECK(context, allocations[2] == 1);
+}
+
+// RandomizeObjects clears the level and refills it; the arena must not grow
+// with each call the way it did before ClearObjects reset it
+SELFTEST_CASE(ObjectArena_LevelRefillsInPlace) {
+    const int REFILLS = 50;
+    LevelGenerator generator(25u);
+    std::unique_ptr<Level> level = generator.GenerateLevel(40, 2500u);
+    if (!SELFTEST_CHECK(context, level && !level->GetObjects().empty())) return;
+
+    const size_t bytesBefore = level->GetArena().GetBytesUsed();
+    size_t mostChunks = 0;
+    for (int i = 0; i < REFILLS; i++) {
+        level->RandomizeObjects();
+        // Refills only ever drop objects that don't fit, so never need more room
+        SELFTEST_CHECK(context, level->GetArena().GetBytesUsed() <= bytesBefore);
+        if (i > 0) mostChunks = std::max(mostChunks, level->GetArena().GetChunkCount());
+    }
+    context.Log("%zu bytes before, %zu after %d refills, at most %zu chunks",
+                bytesBefore, level->GetArena().GetBytesUsed(), REFILLS, mostChunks);
+    SELFTEST_CHECK(context, mostChunks <= static_cast<size_t>(GameObject::Type::Count));
+}
+
+// Update and Draw over the same levels with objects in the arena and on a
+// scattered heap, warm and with the caches emptied before each frame. The
+// game's frames are cold more often than not: the rest of the frame pushes
+// the level out between them. Run headless, Draw's GL calls have no context
+// and go nowhere, so it times the walk over the objects rather than the
+// drawing.
+SELFTEST_BENCHMARK(ObjectArena_UpdateAndDraw) {
+    const int LEVELS = 200;
+    const int WARM_FRAMES = 20;
+    const int COLD_FRAMES = 2;
+    const int ROUNDS = 5;
+    const int STRESS_COLLECTIBLES = 1000;
+
+    LevelGenerator generator(26u);
+    std::vector<std::unique_ptr<Level>> generated[2];
+    std::vector<std::unique_ptr<Level>> stress[2];
+    std::mt19937 rng(26);
+    std::vector<std::unique_ptr<char[]>> noise;
+    for (int i = 0; i < LEVELS; i++) {
+        std::unique_ptr<Level> level = generator.GenerateLevel(i % 60, 2600u + i);
+        generated[1].push_back(HeapCopy(*level, rng, noise));
+        generated[0].push_back(std::move(level));
+    }
+    std::unique_ptr<Level> level = generator.GenerateCollectibleStressLevel(STRESS_COLLECTIBLES);
+    stress[1].push_back(HeapCopy(*level, rng, noise));
+    stress[0].push_back(std::move(level));
+
+    // Best of a few rounds, the layouts taking turns so neither runs on a
+    // quieter machine than the other
+    std::vector<unsigned char> sweep(EVICT_BYTES);
+    double best[2][4];
+    std::fill(&best[0][0], &best[0][0] + 8, 1e9);
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int layout = 0; layout < 2; layout++) {
+            const double times[4] = {
+                TimeFrames(generated[layout], WARM_FRAMES, nullptr),
+                TimeFrames(generated[layout], COLD_FRAMES, &sweep),
+                TimeFrames(stress[layout], WARM_FRAMES, nullptr),
+                TimeFrames(stress[layout], COLD_FRAMES * 10, &sweep),
+            };
+            for (int i = 0; i < 4; i++) best[layout][i] = std::min(best[layout][i], times[i]);
+        }
+    }
+    const char* const LAYOUTS[] = { "arena", "heap" };
+    for (int layout = 0; layout < 2; layout++) {
+        context.Log("%s: generated levels %.2f us warm, %.2f us cold; %d collectibles %.1f us warm, %.1f us cold",
+                    LAYOUTS[layout], best[layout][0], best[layout][1], STRESS_COLLECTIBLES, best[layout][2], best[layout][3]);
+    }
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "PoissonDisk.h"
+#include <algorithm>
+#include <cmath>
+
+namespace PoissonDisk {
+
+    void Sample(float left, float top, float right, float bottom, float minDistance, std::mt19937& rng,
+                const AcceptFn& accept, std::vector<Point>& out, int maxPoints, int attempts,
+                SampleStats* stats) {
+        SampleStats local = { 0, 0, 0 };
+        out.clear();
+        if (right < left || bottom < top || minDistance <= 0.0f) {
+            if (stats) *stats = local;
+            return;
+        }
+
+        // Cell diagonal equals minDistance, so a cell never holds two points
+        const float cellSize = minDistance / sqrtf(2.0f);
+        const float invCellSize = 1.0f / cellSize;
+        const int columns = std::max(1, static_cast<int>(ceilf((right - left) * invCellSize)));
+        const int rows = std::max(1, static_cast<int>(ceilf((bottom - top) * invCellSize)));
+        std::vector<int> grid(columns * rows, -1);
+        std::vector<int> active;
+
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float minDistanceSquared = minDistance * minDistance;
+
+        auto cellOf = [&](float x, float y, int& column, int& row) {
+            column = std::min(columns - 1, static_cast<int>((x - left) * invCellSize));
+            row = std::min(rows - 1, static_cast<int>((y - top) * invCellSize));
+        };
+
+        auto isSpaced = [&](float x, float y) {
+            if (x < left || x > right || y < top || y > bottom) return false;
+            int column, row;
+            cellOf(x, y, column, row);
+            for (int r = std::max(0, row - 2); r <= std::min(rows - 1, row + 2); r++) {
+                for (int c = std::max(0, column - 2); c <= std::min(columns - 1, column + 2); c++) {
+                    int index = grid[r * columns + c];
+                    if (index < 0) continue;
+                    float dx = out[index].x - x;
+                    float dy = out[index].y - y;
+                    if (dx * dx + dy * dy < minDistanceSquared) return false;
+                }
+            }
+            return true;
+        };
+
+        // Spacing first: it's the cheap test, and most candidates fail it
+        auto tryPoint = [&](float x, float y) {
+            local.candidates++;
+            if (!isSpaced(x, y)) return false;
+            if (accept && !accept(x, y)) {
+                local.vetoed++;
+                return false;
+            }
+            int column, row;
+            cellOf(x, y, column, row);
+            grid[row * columns + column] = static_cast<int>(out.size());
+            active.push_back(static_cast<int>(out.size()));
+            out.push_back(Point{ x, y });
+            return true;
+        };
+
+        int failedSeeds = 0;
+        while (failedSeeds < attempts && !(maxPoints > 0 && static_cast<int>(out.size()) >= maxPoints)) {
+            if (active.empty()) {
+                float x = left + unit(rng) * (right - left);
+                float y = top + unit(rng) * (bottom - top);
+                if (tryPoint(x, y)) {
+                    local.seeds++;
+                } else {
+                    failedSeeds++;
+                }
+                continue;
+            }
+
+            int slot = std::min(static_cast<int>(unit(rng) * active.size()), static_cast<int>(active.size()) - 1);
+            const Point origin = out[active[slot]];
+
+            bool placed = false;
+            for (int k = 0; k < attempts && !placed; k++) {
+                float angle = unit(rng) * 6.2831853f;
+                float radius = minDistance * (1.0f + unit(rng));
+                placed = tryPoint(origin.x + cosf(angle) * radius, origin.y + sinf(angle) * radius);
+            }
+
+            // Nothing fits around it any more
+            if (!placed) {
+                active[slot] = active.back();
+                active.pop_back();
+            }
+        }
+
+        if (stats) *stats = local;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include <random>
+#include <vector>
+
+// Bridson's blue-noise sampling: points no closer than minDistance, spread
+// evenly, in time linear in the number of points. A background grid of
+// minDistance/sqrt(2) cells holds at most one point each, so the spacing test
+// only looks at the 5x5 cells around a candidate.
+namespace PoissonDisk {
+
+    struct Point {
+        float x, y;
+    };
+
+    struct SampleStats {
+        int candidates;     // Positions generated
+        int vetoed;         // Spaced correctly but refused by `accept`
+        int seeds;          // Growth restarts (walls can cut the area into pockets)
+    };
+
+    // Vetoes a candidate position, e.g. too close to a wall or the tee
+    using AcceptFn = std::function<bool(float x, float y)>;
+
+    // Fills `out` with samples in [left, right] x [top, bottom]. New points are
+    // tried in the ring [minDistance, 2 * minDistance) around each active one,
+    // `attempts` times before it retires. When growth stalls, up to `attempts`
+    // random seeds are tried to reach pockets the ring walk can't cross into.
+    // maxPoints > 0 stops early.
+    void Sample(float left, float top, float right, float bottom, float minDistance, std::mt19937& rng,
+                const AcceptFn& accept, std::vector<Point>& out, int maxPoints = 0, int attempts = 30,
+                SampleStats* stats = nullptr);
+}
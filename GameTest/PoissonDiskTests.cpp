@@ -0,0 +1,46 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "PoissonDisk.h"
+#include <random>
+#include <vector>
+
+// Every sample is inside the area and no two are closer than the spacing,
+// with and without a veto and with a cap on the count. Checked pair by pair.
+SELFTEST_CASE(PoissonDisk_SamplesAreSpacedAndInBounds) {
+    const float LEFT = 40.0f, TOP = 60.0f, RIGHT = 980.0f, BOTTOM = 720.0f;
+    const float SPACINGS[] = { 12.0f, 30.0f, 75.0f };
+
+    // A wall down the middle, as placement sees one
+    const PoissonDisk::AcceptFn wall = [](float x, float) { return x < 480.0f || x > 520.0f; };
+    const PoissonDisk::AcceptFn cases[] = { PoissonDisk::AcceptFn(), wall };
+
+    std::mt19937 rng(19);
+    for (float spacing : SPACINGS) {
+        for (const PoissonDisk::AcceptFn& accept : cases) {
+            for (int maxPoints : { 0, 50 }) {
+                std::vector<PoissonDisk::Point> points;
+                PoissonDisk::Sample(LEFT, TOP, RIGHT, BOTTOM, spacing, rng, accept, points, maxPoints);
+                if (!SELFTEST_CHECK(context, !points.empty())) continue;
+                if (maxPoints > 0) SELFTEST_CHECK(context, static_cast<int>(points.size()) <= maxPoints);
+
+                int outside = 0;
+                int vetoed = 0;
+                int close = 0;
+                for (size_t i = 0; i < points.size(); i++) {
+                    const PoissonDisk::Point& p = points[i];
+                    outside += p.x < LEFT || p.x > RIGHT || p.y < TOP || p.y > BOTTOM;
+                    vetoed += accept && !accept(p.x, p.y);
+                    for (size_t j = i + 1; j < points.size(); j++) {
+                        const float dx = p.x - points[j].x;
+                        const float dy = p.y - points[j].y;
+                        close += dx * dx + dy * dy < spacing * spacing;
+                    }
+                }
+                if (maxPoints == 0) {
+                    context.Log("spacing %.0f%s: %zu samples", spacing, accept ? ", walled" : "", points.size());
+                }
+                SELFTEST_CHECK(context, outside == 0 && vetoed == 0 && close == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace SelfTest {
+
+    namespace {
+        struct Entry {
+            const char* name;
+            CaseFunction function;
+            bool benchmark;
+        };
+
+        // Function-local so registration from other files' static
+        // initializers never sees it unconstructed
+        std::vector<Entry>& Registry() {
+            static std::vector<Entry> entries;
+            return entries;
+        }
+
+        void Append(std::string& out, const char* format, va_list args) {
+            char buffer[512];
+            vsnprintf(buffer, sizeof(buffer), format, args);
+            out += buffer;
+        }
+
+        void Append(std::string& out, const char* format, ...) {
+            va_list args;
+            va_start(args, format);
+            Append(out, format, args);
+            va_end(args);
+        }
+    }
+
+    bool Context::Check(bool passed, const char* expression, const char* file, int line) {
+        m_checks++;
+        if (!passed) {
+            m_failures++;
+            const char* slash = std::max(strrchr(file, '/'), strrchr(file, '\\'));
+            Append(m_report, "    failed: %s (%s:%d)\n", expression, slash ? slash + 1 : file, line);
+        }
+        return passed;
+    }
+
+    void Context::Log(const char* format, ...) {
+        m_report += "    ";
+        va_list args;
+        va_start(args, format);
+        Append(m_report, format, args);
+        va_end(args);
+        m_report += "\n";
+    }
+
+    Registrar::Registrar(const char* name, CaseFunction function, bool benchmark) {
+        Registry().push_back(Entry{ name, function, benchmark });
+    }
+
+    Summary Run(const std::string& filter, bool includeBenchmarks, std::string& report) {
+        std::vector<Entry> entries = Registry();
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return strcmp(a.name, b.name) < 0; });
+
+        Summary summary;
+        for (const Entry& entry : entries) {
+            if (entry.benchmark && !includeBenchmarks) continue;
+            if (!filter.empty() && !strstr(entry.name, filter.c_str())) continue;
+
+            std::string log;
+            Context context(log);
+            const auto start = std::chrono::steady_clock::now();
+            entry.function(context);
+            const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            summary.cases++;
+            summary.checks += context.GetChecks();
+            summary.failedChecks += context.GetFailures();
+            if (context.GetFailures() > 0) summary.failedCases++;
+
+            Append(report, "%s %s (%.1f ms)\n", context.GetFailures() > 0 ? "FAIL" : "ok  ", entry.name, elapsedMs);
+            report += log;
+        }
+        Append(report, "%d cases, %d failed; %d checks, %d failed\n",
+               summary.cases, summary.failedCases, summary.checks, summary.failedChecks);
+        return summary;
+    }
+}
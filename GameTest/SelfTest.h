@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+
+// In-game checks that need no window or GL context. Cases register
+// themselves from the *Tests.cpp files next to the code they cover and run
+// from the command line (see RunCommandLine in GameTest.cpp), before Init(),
+// so nothing they do reaches the game's event subscribers. Benchmark cases
+// time things and log the numbers; they run only when asked for, since some
+// take seconds.
+namespace SelfTest {
+
+    class Context {
+    public:
+        explicit Context(std::string& report) : m_report(report), m_checks(0), m_failures(0) {}
+
+        // Records one check; returns `passed` so a case can bail out early
+        bool Check(bool passed, const char* expression, const char* file, int line);
+        void Log(const char* format, ...);
+
+        int GetChecks() const { return m_checks; }
+        int GetFailures() const { return m_failures; }
+
+    private:
+        std::string& m_report;
+        int m_checks;
+        int m_failures;
+    };
+
+    typedef void (*CaseFunction)(Context& context);
+
+    struct Registrar {
+        Registrar(const char* name, CaseFunction function, bool benchmark);
+    };
+
+    struct Summary {
+        int cases = 0;
+        int failedCases = 0;
+        int checks = 0;
+        int failedChecks = 0;
+    };
+
+    // Runs every case whose name contains `filter` (all of them when it's
+    // empty), in name order, and appends what they logged to `report`
+    Summary Run(const std::string& filter, bool includeBenchmarks, std::string& report);
+}
+
+#define SELFTEST_CHECK(context, condition) (context).Check((condition), #condition, __FILE__, __LINE__)
+
+#define SELFTEST_REGISTER(name, benchmark) \
+    static void name(SelfTest::Context& context); \
+    static const SelfTest::Registrar name##Registrar(#name, name, benchmark); \
+    static void name(SelfTest::Context& context)
+
+#define SELFTEST_CASE(name) SELFTEST_REGISTER(name, false)
+#define SELFTEST_BENCHMARK(name) SELFTEST_REGISTER(name, true)
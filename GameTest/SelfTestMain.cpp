@@ -0,0 +1,23 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include <cstdio>
+#include <string>
+
+// Entry point for the CMake self-test target, which builds only the modules
+// that don't need App/GL. The game runs the same cases through
+// GameTest.exe --selftest; the switches here match it:
+//   GameTestSelfTest [--selftest] [filter]        quick checks
+//   GameTestSelfTest --selftest-benchmarks [filter]   quick checks plus the timed cases
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "--selftest";
+    const bool benchmarks = mode == "--selftest-benchmarks";
+    if (!benchmarks && mode != "--selftest") {
+        fprintf(stderr, "usage: %s [--selftest | --selftest-benchmarks] [filter]\n", argv[0]);
+        return 2;
+    }
+
+    std::string report;
+    const SelfTest::Summary summary = SelfTest::Run(argc > 2 ? argv[2] : "", benchmarks, report);
+    fputs(report.c_str(), stdout);
+    return summary.failedCases > 0 || summary.cases == 0 ? 1 : 0;
+}
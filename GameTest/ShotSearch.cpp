@@ -0,0 +1,155 @@
+#include "stdafx.h"
+#include "ShotSearch.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace ShotSearch {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // A resting ball the search can play on from
+        struct Node {
+            float x, y;
+            int parent;                 // Index into the node list; -1 for the tee
+            ShotSimulator::ShotParams shot;     // Stroke that reached it from the parent
+        };
+
+        struct Landing {
+            float x, y;
+            bool holed;
+            bool simulated;             // False when skipped for budget or an earlier hole
+        };
+
+        // Resting spots closer than this are treated as the same position
+        const float SAME_SPOT_DISTANCE = 8.0f;
+
+        void CollectLine(const std::vector<Node>& nodes, int node, std::vector<ShotSimulator::ShotParams>& shots) {
+            for (; node > 0; node = nodes[node].parent) {
+                shots.push_back(nodes[node].shot);
+            }
+            std::reverse(shots.begin(), shots.end());
+        }
+    }
+
+    SearchResult FindSolution(const LevelSnapshot& level, ThreadPool& pool, const SearchOptions& options) {
+        SearchResult result;
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline = start +
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(options.budgetMs));
+
+        ShotSimulator::ShotOptions shotOptions;
+        shotOptions.recordPath = false;
+        shotOptions.maxTime = options.maxShotSeconds;
+
+        std::vector<ShotSimulator::ShotParams> grid;
+        grid.reserve(options.powerSteps * options.angleSteps);
+        for (int p = 1; p <= options.powerSteps; p++) {
+            for (int a = 0; a < options.angleSteps; a++) {
+                float angle = a * (6.2831853f / options.angleSteps);
+                grid.push_back(ShotSimulator::ShotParams{ options.maxPower * p / options.powerSteps, angle });
+            }
+        }
+        const int gridSize = static_cast<int>(grid.size());
+        const float holeX = level.world.hole.x;
+        const float holeY = level.world.hole.y;
+
+        std::vector<Node> nodes;
+        nodes.push_back(Node{ level.ball.x, level.ball.y, -1, ShotSimulator::ShotParams{ 0.0f, 0.0f } });
+        std::vector<int> frontier(1, 0);
+
+        long long candidateBase = 0;    // Grid index of the stroke's first candidate, for maxCandidates
+        bool cutShort = false;
+
+        for (int stroke = 0; stroke < options.maxShots && !frontier.empty() && gridSize > 0; stroke++) {
+            // One snapshot per starting point, ball moved onto it
+            std::vector<LevelSnapshot> starts(frontier.size(), level);
+            for (size_t i = 0; i < frontier.size(); i++) {
+                starts[i].ball.x = nodes[frontier[i]].x;
+                starts[i].ball.y = nodes[frontier[i]].y;
+            }
+
+            const int count = static_cast<int>(frontier.size()) * gridSize;
+            std::vector<Landing> landings(count, Landing{ 0.0f, 0.0f, false, false });
+            std::atomic<bool> holed(false);
+            std::atomic<bool> outOfTime(false);
+
+            // The candidate cap is applied before the stroke starts rather than
+            // by the workers, so which candidates run never depends on timing
+            int limit = count;
+            if (options.maxCandidates > 0 && candidateBase + count > options.maxCandidates) {
+                limit = static_cast<int>(std::max(options.maxCandidates - candidateBase, 0LL));
+            }
+
+            pool.ParallelFor(limit, [&](int i) {
+                if (holed.load(std::memory_order_relaxed) || outOfTime.load(std::memory_order_relaxed)) return;
+                if (options.budgetMs > 0.0f && Clock::now() >= deadline) {
+                    outOfTime.store(true, std::memory_order_relaxed);
+                    return;
+                }
+
+                const ShotSimulator::ShotParams& shot = grid[i % gridSize];
+                ShotSimulator::ShotOutcome outcome =
+                    ShotSimulator::SimulateShot(starts[i / gridSize], shot.power, shot.angle, shotOptions);
+                landings[i] = Landing{ outcome.finalX, outcome.finalY, outcome.holed, true };
+                if (outcome.holed) holed.store(true, std::memory_order_relaxed);
+            });
+            candidateBase += count;
+
+            // Lowest holing index wins, so the reported line doesn't depend on thread order
+            for (int i = 0; i < count; i++) {
+                if (!landings[i].simulated) continue;
+                result.candidates++;
+                if (landings[i].holed && !result.solved) {
+                    nodes.push_back(Node{ landings[i].x, landings[i].y, frontier[i / gridSize], grid[i % gridSize] });
+                    CollectLine(nodes, static_cast<int>(nodes.size()) - 1, result.shots);
+                    result.solved = true;
+                }
+            }
+            if (result.solved) break;
+            if (limit < count || outOfTime.load()) {
+                cutShort = true;
+                break;
+            }
+
+            // Carry the landings nearest the hole into the next stroke
+            std::vector<int> order;
+            order.reserve(count);
+            for (int i = 0; i < count; i++) {
+                order.push_back(i);
+            }
+            auto holeDistance = [&](int i) {
+                float dx = landings[i].x - holeX;
+                float dy = landings[i].y - holeY;
+                return dx * dx + dy * dy;
+            };
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return holeDistance(a) < holeDistance(b); });
+
+            std::vector<int> next;
+            for (int i : order) {
+                if (static_cast<int>(next.size()) >= options.beamWidth) break;
+
+                bool seen = false;
+                for (const Node& node : nodes) {
+                    float dx = landings[i].x - node.x;
+                    float dy = landings[i].y - node.y;
+                    if (dx * dx + dy * dy < SAME_SPOT_DISTANCE * SAME_SPOT_DISTANCE) {
+                        seen = true;
+                        break;
+                    }
+                }
+                if (seen) continue;
+
+                nodes.push_back(Node{ landings[i].x, landings[i].y, frontier[i / gridSize], grid[i % gridSize] });
+                next.push_back(static_cast<int>(nodes.size()) - 1);
+            }
+            frontier.swap(next);
+        }
+
+        result.complete = result.solved || !cutShort;
+        result.elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+        return result;
+    }
+}
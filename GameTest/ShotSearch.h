@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include "ShotSimulator.h"
+
+class ThreadPool;
+
+// Looks for a way to hole a LevelSnapshot in at most `maxShots` strokes by
+// simulating a grid of (power, angle) shots on the pool. Multi-shot lines are
+// a beam search: after each stroke the resting positions that ended nearest
+// the hole are carried into the next one. Enemies restart from their snapshot
+// clocks on every stroke, which is close enough for a reachability check.
+namespace ShotSearch {
+
+    struct SearchOptions {
+        int powerSteps = 6;             // Powers maxPower/powerSteps .. maxPower
+        int angleSteps = 48;            // Evenly spaced over the full turn
+        float maxPower = 100.0f;        // GameTest's MAX_POWER
+        int maxShots = 3;               // Usually the level's par
+        int beamWidth = 6;              // Resting positions carried to the next stroke
+        float budgetMs = 50.0f;         // Wall-clock budget; 0 = none. Results then vary by machine
+                                        // (LevelGenerator turns it off and uses maxCandidates)
+        long long maxCandidates = 0;    // Deterministic cap on simulations; 0 = none
+        float maxShotSeconds = 12.0f;   // Per simulated shot
+    };
+
+    struct SearchResult {
+        bool solved = false;
+        bool complete = false;          // Not cut short by the budget: !solved means no line in the beam
+        std::vector<ShotSimulator::ShotParams> shots;   // The line found, first stroke first
+        long long candidates = 0;       // Shots simulated
+        float elapsedMs = 0.0f;
+
+        float CandidatesPerSecond() const {
+            return elapsedMs > 0.0f ? candidates * 1000.0f / elapsedMs : 0.0f;
+        }
+    };
+
+    SearchResult FindSolution(const LevelSnapshot& level, ThreadPool& pool,
+                              const SearchOptions& options = SearchOptions());
+}
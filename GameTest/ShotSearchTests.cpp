@@ -0,0 +1,63 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "ShotSearch.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+namespace {
+    LevelSnapshot MakeField(float holeX, float holeY) {
+        LevelSnapshot level;
+        level.world.width = 1024.0f;
+        level.world.height = 768.0f;
+        level.world.hole = { holeX, holeY, 10.0f, 200.0f, true };
+        level.ball.x = level.startX = 200.0f;
+        level.ball.y = level.startY = 400.0f;
+        return level;
+    }
+
+    // Wall-clock budget off, so the outcome is the same on any machine
+    ShotSearch::SearchOptions MakeOptions(int maxShots) {
+        ShotSearch::SearchOptions options;
+        options.maxShots = maxShots;
+        options.budgetMs = 0.0f;
+        return options;
+    }
+}
+
+// An open field with the cup 15 degrees above the tee, which is on the search's
+// 7.5 degree grid: one stroke does it, and the line reported holes when
+// played back stroke by stroke
+SELFTEST_CASE(ShotSearch_FindsOpenShot) {
+    const LevelSnapshot level = MakeField(500.0f, 400.0f - 300.0f * tanf(15.0f * 3.14159265f / 180.0f));
+    ThreadPool pool(4);
+    const ShotSearch::SearchResult result = ShotSearch::FindSolution(level, pool, MakeOptions(2));
+    context.Log("%lld candidates, %zu strokes", result.candidates, result.shots.size());
+    if (!SELFTEST_CHECK(context, result.solved && result.complete && !result.shots.empty())) return;
+    SELFTEST_CHECK(context, result.shots.size() == 1);
+
+    LevelSnapshot playing = level;
+    bool holed = false;
+    for (const ShotSimulator::ShotParams& shot : result.shots) {
+        const ShotSimulator::ShotOutcome outcome = ShotSimulator::SimulateShot(playing, shot.power, shot.angle);
+        holed = outcome.holed;
+        playing.ball.x = outcome.finalX;
+        playing.ball.y = outcome.finalY;
+    }
+    SELFTEST_CHECK(context, holed);
+}
+
+// A cup walled in on all four sides can't be reached: the search runs to
+// the end and says so rather than giving up early
+SELFTEST_CASE(ShotSearch_ReportsSealedHoleUnsolvable) {
+    LevelSnapshot level = MakeField(750.0f, 400.0f);
+    level.world.AddWall(BallPhysics::MakeOrientedBox(750.0f, 300.0f, 220.0f, 20.0f, 0.0f));
+    level.world.AddWall(BallPhysics::MakeOrientedBox(750.0f, 500.0f, 220.0f, 20.0f, 0.0f));
+    level.world.AddWall(BallPhysics::MakeOrientedBox(650.0f, 400.0f, 20.0f, 220.0f, 0.0f));
+    level.world.AddWall(BallPhysics::MakeOrientedBox(850.0f, 400.0f, 20.0f, 220.0f, 0.0f));
+
+    ThreadPool pool(4);
+    const ShotSearch::SearchResult result = ShotSearch::FindSolution(level, pool, MakeOptions(2));
+    context.Log("%lld candidates", result.candidates);
+    SELFTEST_CHECK(context, !result.solved && result.complete && result.shots.empty());
+    SELFTEST_CHECK(context, result.candidates > 0);
+}
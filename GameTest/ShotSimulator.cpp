@@ -0,0 +1,143 @@
+#include "stdafx.h"
+#include "ShotSimulator.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+namespace ShotSimulator {
+
+    namespace {
+        void AddPathPoint(ShotOutcome& outcome, const BallPhysics::BallState& ball) {
+            BallPhysics::PathPoint point = { ball.x, ball.y };
+            outcome.path.push_back(point);
+        }
+
+        // Disc an active enemy never leaves, grown by both radii: a ball centre
+        // outside it can't be touching the enemy, so the patrol isn't evaluated
+        struct EnemyReach {
+            int index;
+            float x, y;
+            float reachSquared;
+        };
+
+        const float REACH_SLACK = 1.0f;
+    }
+
+    ShotOutcome SimulateShot(const LevelSnapshot& level, float power, float angle, const ShotOptions& options) {
+        ShotOutcome outcome;
+
+        BallPhysics::BallState ball = { level.ball.x, level.ball.y, 0.0f, 0.0f, level.ball.radius, true,
+                                        level.ball.phaseMode };
+        BallPhysics::LaunchVelocity(power, angle, level.ball.speedMultiplier, ball.vx, ball.vy);
+
+        // Collectibles only count once per shot, so track them locally
+        std::vector<bool> collected(level.collectibles.size());
+        for (size_t i = 0; i < level.collectibles.size(); i++) {
+            collected[i] = level.collectibles[i].collected;
+        }
+
+        std::vector<EnemyReach> reachable;
+        if (!level.ball.enemyImmune) {
+            reachable.reserve(level.enemies.size());
+            for (size_t i = 0; i < level.enemies.size(); i++) {
+                const EnemySnapshot& enemy = level.enemies[i];
+                if (!enemy.active) continue;
+                float reach = enemy.patrol.GetReach() + enemy.radius + ball.radius + REACH_SLACK;
+                reachable.push_back(EnemyReach{ static_cast<int>(i), enemy.patrol.startX, enemy.patrol.startY,
+                                                reach * reach });
+            }
+        }
+
+        std::vector<BallPhysics::PathPoint>* path = options.recordPath ? &outcome.path : nullptr;
+        if (path) AddPathPoint(outcome, ball);
+
+        const float step = options.step;
+        float elapsed = 0.0f;
+
+        while (ball.moving && elapsed < options.maxTime) {
+            // Ball::Update
+            BallPhysics::AdvanceResult result = BallPhysics::AdvanceAnalytic(ball, level.world, step, 64, path);
+            outcome.wallHits += result.wallHits;
+            outcome.boundaryHits += result.boundaryHits;
+
+            // Ball::CheckCollision against each wall
+            if (!ball.ignoreWalls) {
+                BallPhysics::ResolveWallOverlaps(ball, level.world);
+            }
+
+            // Enemies tick after the ball in Level::Update, so they are still
+            // where the previous step left them. Patrols are only evaluated
+            // for enemies whose reach covers the ball.
+            outcome.enemyChecks += static_cast<int>(reachable.size());
+            for (const EnemyReach& reach : reachable) {
+                float reachX = ball.x - reach.x;
+                float reachY = ball.y - reach.y;
+                if (reachX * reachX + reachY * reachY >= reach.reachSquared) continue;
+
+                outcome.enemyChecks++;
+                const EnemySnapshot& enemy = level.enemies[reach.index];
+                float enemyX, enemyY;
+                enemy.PositionAt(elapsed, enemyX, enemyY);
+
+                float dx = ball.x - enemyX;
+                float dy = ball.y - enemyY;
+                float minDistance = ball.radius + enemy.radius;
+                if (dx * dx + dy * dy < minDistance * minDistance) {
+                    float bounceAngle = atan2f(dy, dx);
+                    ball.vx = cosf(bounceAngle) * BallPhysics::ENEMY_BOUNCE_SPEED;
+                    ball.vy = sinf(bounceAngle) * BallPhysics::ENEMY_BOUNCE_SPEED;
+                    ball.moving = true;
+                    outcome.enemyContacts.push_back(EnemyContact{ reach.index, elapsed, ball.x, ball.y, enemyX, enemyY });
+                    if (path) AddPathPoint(outcome, ball);
+                }
+            }
+
+            for (size_t i = 0; i < level.collectibles.size(); i++) {
+                if (collected[i]) continue;
+
+                const CollectibleSnapshot& collectible = level.collectibles[i];
+                float dx = ball.x - collectible.x;
+                float dy = ball.y - collectible.y;
+                float minDistance = ball.radius + collectible.radius;
+                if (dx * dx + dy * dy < minDistance * minDistance) {
+                    collected[i] = true;
+                    outcome.collectiblesHit.push_back(static_cast<int>(i));
+                }
+            }
+
+            if (ball.moving && BallPhysics::IsInHole(level.world.hole, ball.x, ball.y, ball.vx, ball.vy)) {
+                BallPhysics::Stop(ball);
+                outcome.holed = true;
+            }
+
+            elapsed += step;
+            outcome.steps++;
+
+            if (options.maxContacts > 0 && ball.moving &&
+                outcome.wallHits + outcome.boundaryHits + static_cast<int>(outcome.enemyContacts.size()) >= options.maxContacts) {
+                outcome.truncated = true;
+                break;
+            }
+            // Checked after the step, so a budget can be overrun by one step's worth of enemies
+            if (options.maxEnemyChecks > 0 && ball.moving && outcome.enemyChecks >= options.maxEnemyChecks) {
+                outcome.truncated = true;
+                break;
+            }
+        }
+
+        if (path) AddPathPoint(outcome, ball);
+
+        outcome.finalX = ball.x;
+        outcome.finalY = ball.y;
+        outcome.duration = elapsed;
+        return outcome;
+    }
+
+    std::vector<ShotOutcome> SimulateShots(const LevelSnapshot& level, const std::vector<ShotParams>& shots,
+                                           ThreadPool& pool, const ShotOptions& options) {
+        std::vector<ShotOutcome> outcomes(shots.size());
+        pool.ParallelFor(static_cast<int>(shots.size()), [&](int i) {
+            outcomes[i] = SimulateShot(level, shots[i].power, shots[i].angle, options);
+        });
+        return outcomes;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include "LevelSnapshot.h"
+#include "SimClock.h"
+
+class ThreadPool;
+
+// Plays a shot out against a LevelSnapshot without touching the live game.
+// Steps the same way Level::Update does (ball, walls, enemies, collectibles,
+// hole), so the outcome matches what the player would see. No App/GL
+// dependencies; safe to call from any thread.
+namespace ShotSimulator {
+
+    struct ShotParams {
+        float power;    // Drag length, as passed to Ball::ApplyForce
+        float angle;
+    };
+
+    // Enemy work one preview may do, whatever the level holds
+    constexpr int PREVIEW_ENEMY_CHECKS = 20000;
+
+    struct ShotOptions {
+        bool recordPath = true;
+        float maxTime = 30.0f;                          // Seconds before giving up
+        float step = FixedStepClock::STEP_SECONDS;      // Tick length the game runs at
+        int maxContacts = 0;    // Stop after this many wall/boundary/enemy bounces; 0 = play it out
+        int maxEnemyChecks = 0; // Stop after this many enemy reach tests and patrol evaluations; 0 = no limit
+
+        // Aim preview: same stepping, but only as far as the first few bounces
+        // and a fixed amount of enemy work however many enemies there are
+        static ShotOptions Preview(int contacts = 5) {
+            ShotOptions options;
+            options.maxContacts = contacts;
+            options.maxEnemyChecks = PREVIEW_ENEMY_CHECKS;
+            return options;
+        }
+    };
+
+    // A predicted deflection off an enemy
+    struct EnemyContact {
+        int enemy;              // Index into LevelSnapshot::enemies
+        float time;             // Seconds into the shot
+        float ballX, ballY;     // Ball centre at contact
+        float enemyX, enemyY;   // Where the enemy will be then
+    };
+
+    struct ShotOutcome {
+        float finalX = 0.0f;
+        float finalY = 0.0f;
+        bool holed = false;
+        std::vector<BallPhysics::PathPoint> path;   // Start, every bounce, end
+        int wallHits = 0;
+        int boundaryHits = 0;
+        std::vector<EnemyContact> enemyContacts;
+        std::vector<int> collectiblesHit;   // Indices into LevelSnapshot::collectibles
+        float duration = 0.0f;
+        int steps = 0;
+        int enemyChecks = 0;                // Reach tests plus patrol evaluations
+        bool truncated = false;             // Cut off by maxContacts or maxEnemyChecks while still rolling
+    };
+
+    ShotOutcome SimulateShot(const LevelSnapshot& level, float power, float angle,
+                             const ShotOptions& options = ShotOptions());
+
+    // Runs every shot on the pool; outcomes come back in the order of `shots`.
+    std::vector<ShotOutcome> SimulateShots(const LevelSnapshot& level, const std::vector<ShotParams>& shots,
+                                           ThreadPool& pool, const ShotOptions& options = ShotOptions());
+}
@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "ShotSimulator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Headless on purpose: the snapshot is built by hand rather than from a
+// Level, so this case runs in the CMake self-test target as well.
+
+namespace {
+    // A course-sized field with straight and rotated walls, a cup, both
+    // moving enemy patterns and a row of pickups
+    LevelSnapshot MakeCourse() {
+        LevelSnapshot level;
+        level.world.width = 1024.0f;
+        level.world.height = 768.0f;
+        level.world.AddWall(BallPhysics::MakeOrientedBox(400.0f, 300.0f, 20.0f, 300.0f, 0.0f));
+        level.world.AddWall(BallPhysics::MakeOrientedBox(650.0f, 500.0f, 240.0f, 20.0f, 30.0f));
+        level.world.AddWall(BallPhysics::MakeOrientedBox(800.0f, 200.0f, 20.0f, 180.0f, -45.0f));
+        level.world.hole = { 880.0f, 600.0f, 10.0f, 200.0f, true };
+
+        EnemySnapshot circling = {};
+        circling.patrol = { PatrolPattern::Circular, 600.0f, 250.0f, 40.0f, 60.0f, 0.0f };
+        circling.radius = 15.0f;
+        circling.active = true;
+        circling.patrol.Evaluate(circling.angle, circling.time, circling.x, circling.y);
+        level.enemies.push_back(circling);
+
+        EnemySnapshot pacing = {};
+        pacing.patrol = { PatrolPattern::Linear, 300.0f, 600.0f, 30.0f, 0.0f, 120.0f };
+        pacing.radius = 15.0f;
+        pacing.active = true;
+        pacing.patrol.Evaluate(pacing.angle, pacing.time, pacing.x, pacing.y);
+        level.enemies.push_back(pacing);
+
+        for (int i = 0; i < 6; i++) {
+            level.collectibles.push_back(CollectibleSnapshot{ 500.0f + 60.0f * i, 120.0f, 8.0f, false });
+        }
+
+        level.ball.x = level.startX = 150.0f;
+        level.ball.y = level.startY = 400.0f;
+        return level;
+    }
+
+    bool SameOutcome(const ShotSimulator::ShotOutcome& a, const ShotSimulator::ShotOutcome& b) {
+        if (a.finalX != b.finalX || a.finalY != b.finalY || a.holed != b.holed || a.wallHits != b.wallHits ||
+            a.boundaryHits != b.boundaryHits || a.duration != b.duration || a.steps != b.steps ||
+            a.enemyChecks != b.enemyChecks ||
+            a.truncated != b.truncated || a.collectiblesHit != b.collectiblesHit ||
+            a.path.size() != b.path.size() || a.enemyContacts.size() != b.enemyContacts.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.path.size(); i++) {
+            if (a.path[i].x != b.path[i].x || a.path[i].y != b.path[i].y) return false;
+        }
+        for (size_t i = 0; i < a.enemyContacts.size(); i++) {
+            const ShotSimulator::EnemyContact& ca = a.enemyContacts[i];
+            const ShotSimulator::EnemyContact& cb = b.enemyContacts[i];
+            if (ca.enemy != cb.enemy || ca.time != cb.time || ca.ballX != cb.ballX || ca.ballY != cb.ballY ||
+                ca.enemyX != cb.enemyX || ca.enemyY != cb.enemyY) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// SimulateShots hands each shot to a pool worker; every outcome must be
+// bit-identical to a serial SimulateShot and come back in the caller's order
+SELFTEST_CASE(ShotSimulator_BatchMatchesSerial) {
+    const int SHOTS = 600;
+
+    const LevelSnapshot level = MakeCourse();
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> power(0.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::vector<ShotSimulator::ShotParams> shots;
+    for (int i = 0; i < SHOTS; i++) {
+        shots.push_back(ShotSimulator::ShotParams{ power(rng), angle(rng) });
+    }
+
+    ThreadPool pool(4);
+    const ShotSimulator::ShotOptions modes[] = { ShotSimulator::ShotOptions(), ShotSimulator::ShotOptions::Preview() };
+    for (const ShotSimulator::ShotOptions& options : modes) {
+        const std::vector<ShotSimulator::ShotOutcome> batch = ShotSimulator::SimulateShots(level, shots, pool, options);
+        if (!SELFTEST_CHECK(context, batch.size() == shots.size())) return;
+
+        int mismatches = 0;
+        int wallShots = 0;
+        int enemyShots = 0;
+        int pickupShots = 0;
+        for (size_t i = 0; i < shots.size(); i++) {
+            const ShotSimulator::ShotOutcome serial =
+                ShotSimulator::SimulateShot(level, shots[i].power, shots[i].angle, options);
+            if (!SameOutcome(batch[i], serial)) {
+                if (mismatches == 0) context.Log("shot %d differs from its serial run", static_cast<int>(i));
+                mismatches++;
+            }
+            wallShots += serial.wallHits > 0;
+            enemyShots += !serial.enemyContacts.empty();
+            pickupShots += !serial.collectiblesHit.empty();
+        }
+
+        context.Log("%s, %u workers: %d shots (%d off a wall, %d off an enemy, %d with pickups), %d mismatches",
+                    options.maxContacts > 0 ? "preview" : "full", pool.GetThreadCount(), SHOTS,
+                    wallShots, enemyShots, pickupShots, mismatches);
+        SELFTEST_CHECK(context, mismatches == 0);
+        // The course has to exercise the contact paths for the comparison to mean much
+        SELFTEST_CHECK(context, wallShots > 0 && enemyShots > 0 && pickupShots > 0);
+    }
+}
+
+// However many enemies there are, a preview stops once it has spent its
+// enemy budget, and what it has drawn by then is the start of the unlimited path
+SELFTEST_CASE(ShotSimulator_PreviewStaysWithinEnemyBudget) {
+    const int SHOTS = 200;
+    const int ENEMY_COUNTS[] = { 50, 200 };
+
+    std::mt19937 rng(14);
+    std::uniform_real_distribution<float> power(20.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> across(50.0f, 970.0f);
+    std::uniform_real_distribution<float> down(50.0f, 710.0f);
+    for (int enemies : ENEMY_COUNTS) {
+        LevelSnapshot level = MakeCourse();
+        level.enemies.clear();
+        for (int i = 0; i < enemies; i++) {
+            EnemySnapshot enemy = {};
+            enemy.patrol = { i % 2 ? PatrolPattern::Circular : PatrolPattern::Linear, across(rng), down(rng), 30.0f, 60.0f, 80.0f };
+            enemy.radius = 15.0f;
+            enemy.active = true;
+            enemy.patrol.Evaluate(enemy.angle, enemy.time, enemy.x, enemy.y);
+            level.enemies.push_back(enemy);
+        }
+
+        ShotSimulator::ShotOptions unlimited = ShotSimulator::ShotOptions::Preview();
+        unlimited.maxEnemyChecks = 0;
+        int overBudget = 0;
+        int cutShort = 0;
+        int prefixes = 0;
+        double worstUs = 0.0;
+        for (int i = 0; i < SHOTS; i++) {
+            const float shotPower = power(rng);
+            const float shotAngle = angle(rng);
+            const auto start = std::chrono::steady_clock::now();
+            const ShotSimulator::ShotOutcome preview =
+                ShotSimulator::SimulateShot(level, shotPower, shotAngle, ShotSimulator::ShotOptions::Preview());
+            const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            worstUs = std::max(worstUs, us);
+            const ShotSimulator::ShotOutcome full = ShotSimulator::SimulateShot(level, shotPower, shotAngle, unlimited);
+
+            overBudget += preview.enemyChecks > ShotSimulator::PREVIEW_ENEMY_CHECKS + 2 * enemies;
+            cutShort += preview.steps < full.steps;
+            bool prefix = preview.path.size() <= full.path.size() + 1;
+            for (size_t p = 0; prefix && p + 1 < preview.path.size(); p++) {
+                prefix = preview.path[p].x == full.path[p].x && preview.path[p].y == full.path[p].y;
+            }
+            prefixes += prefix;
+        }
+
+        context.Log("%d enemies: %d of %d previews cut short by the budget, worst %.0f us", enemies, cutShort, SHOTS, worstUs);
+        SELFTEST_CHECK(context, overBudget == 0);
+        SELFTEST_CHECK(context, prefixes == SHOTS);
+    }
+}
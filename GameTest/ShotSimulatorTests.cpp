@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "ShotSimulator.h"
+#include "Level.h"
+#include "LevelGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// The preview must land where the game does. Each shot is simulated from a
+// snapshot, then played for real through Level::Update from the same state.
+SELFTEST_CASE(ShotSimulator_MatchesLevelUpdate) {
+    const float TOLERANCE = 1.0f;
+    const int LEVELS = 30;
+    const int RANDOM_SHOTS = 12;
+    const int HOLE_SHOTS = 8;
+    const int MAX_STEPS = 3600;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> power(0.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    LevelGenerator generator(31u);
+    int shots = 0;
+    int within = 0;
+    int holedMismatches = 0;
+    int prefixes = 0;
+    int holedShots = 0;
+    int enemyShots = 0;
+    float worst = 0.0f;
+    for (int levelNumber = 0; levelNumber < LEVELS; levelNumber++) {
+        std::unique_ptr<Level> level = generator.GenerateLevel(levelNumber, 500u + levelNumber);
+        if (!SELFTEST_CHECK(context, level && level->GetBall() && level->GetHole())) return;
+
+        // Random shots, shots straight at the cup and shots at each enemy's
+        // post, so drops and enemy bounces are covered as well as rolling
+        float ballX, ballY, holeX, holeY;
+        level->GetBall()->GetPosition(ballX, ballY);
+        level->GetHole()->GetPosition(holeX, holeY);
+        std::vector<ShotSimulator::ShotParams> shotList;
+        for (int i = 0; i < RANDOM_SHOTS; i++) {
+            shotList.push_back(ShotSimulator::ShotParams{ power(rng), angle(rng) });
+        }
+        for (int i = 0; i < HOLE_SHOTS; i++) {
+            shotList.push_back(ShotSimulator::ShotParams{ 15.0f + 85.0f * i / HOLE_SHOTS, atan2f(holeY - ballY, holeX - ballX) });
+        }
+        for (const EnemySnapshot& enemy : level->CreateSnapshot().enemies) {
+            shotList.push_back(ShotSimulator::ShotParams{ 70.0f, atan2f(enemy.y - ballY, enemy.x - ballX) });
+        }
+
+        for (size_t i = 0; i < shotList.size(); i++) {
+            const float shotPower = shotList[i].power;
+            const float shotAngle = shotList[i].angle;
+
+            // A fresh copy each time, so earlier shots' pickups and enemy motion don't carry over
+            std::unique_ptr<Level> live = level->Clone();
+            const LevelSnapshot snapshot = live->CreateSnapshot();
+            const ShotSimulator::ShotOutcome full = ShotSimulator::SimulateShot(snapshot, shotPower, shotAngle);
+            const ShotSimulator::ShotOutcome preview =
+                ShotSimulator::SimulateShot(snapshot, shotPower, shotAngle, ShotSimulator::ShotOptions::Preview());
+
+            // A truncated preview is the start of the full path
+            bool prefix = preview.path.size() <= full.path.size() + 1;
+            for (size_t p = 0; prefix && p + 1 < preview.path.size(); p++) {
+                prefix = preview.path[p].x == full.path[p].x && preview.path[p].y == full.path[p].y;
+            }
+            prefixes += prefix;
+
+            Ball* ball = live->GetBall();
+            ball->ApplyForce(shotPower, shotAngle);
+            for (int step = 0; step < MAX_STEPS && ball->IsMoving(); step++) {
+                live->Update(SimSeconds(FixedStepClock::STEP_SECONDS));
+            }
+
+            // Level::Update stops a holed ball where it dropped, inside the cup
+            float x, y;
+            ball->GetPosition(x, y);
+            const bool holed = live->GetHole()->IsInHole(x, y);
+            const float distance = hypotf(x - full.finalX, y - full.finalY);
+            worst = std::max(worst, distance);
+            shots++;
+            if (holed != full.holed) holedMismatches++;
+            holedShots += full.holed;
+            enemyShots += !full.enemyContacts.empty();
+            if (distance <= TOLERANCE) {
+                within++;
+            } else {
+                context.Log("level %d shot %d: preview ends %.2fpx from the game", levelNumber, static_cast<int>(i), distance);
+            }
+        }
+    }
+
+    context.Log("%d shots (%d holed, %d off an enemy): %d end within %.0fpx (worst %.2fpx), %d holed mismatches, "
+                "%d previews are prefixes", shots, holedShots, enemyShots, within, TOLERANCE, worst, holedMismatches, prefixes);
+    // Enemy bounces amplify float drift between the live patrol and the
+    // snapshot's closed form, so a couple of shots in a hundred may split
+    SELFTEST_CHECK(context, within >= shots * 98 / 100);
+    SELFTEST_CHECK(context, holedMismatches <= shots / 100);
+    SELFTEST_CHECK(context, prefixes == shots);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+
+// Simulation time is carried in seconds everywhere below the App layer.
+// App/main.cpp hands Update() milliseconds, so convert exactly once at that
+// boundary: SimSeconds(FrameMilliseconds(deltaTime)).
+using SimSeconds = std::chrono::duration<float>;
+using FrameMilliseconds = std::chrono::duration<float, std::milli>;
+
+// Accumulates real frame time and hands out whole fixed simulation steps.
+class FixedStepClock {
+public:
+    // Walls are swept (BallPhysics::SweepCircleBox), so the step only has to be
+    // fine enough for enemy/collectible pickups along the ball's path.
+    static constexpr float STEP_SECONDS = 1.0f / 120.0f;
+    static constexpr int MAX_STEPS_PER_FRAME = 4;  // ~33ms of catch-up before we drop time
+
+    FixedStepClock() : m_accumulator(SimSeconds::zero()), m_lastStepCount(0) {}
+
+    // Adds one rendered frame of time and returns how many fixed steps to run.
+    int Advance(SimSeconds frameTime) {
+        m_accumulator += frameTime;
+
+        int steps = 0;
+        while (m_accumulator.count() >= STEP_SECONDS && steps < MAX_STEPS_PER_FRAME) {
+            m_accumulator -= GetStep();
+            steps++;
+        }
+
+        // A long stall (breakpoint, window drag) shouldn't snowball into more steps next frame
+        if (m_accumulator.count() >= STEP_SECONDS) {
+            m_accumulator = SimSeconds::zero();
+        }
+
+        m_lastStepCount = steps;
+        return steps;
+    }
+
+    void Reset() {
+        m_accumulator = SimSeconds::zero();
+        m_lastStepCount = 0;
+    }
+
+    SimSeconds GetStep() const {
+        const float step = STEP_SECONDS;  // copy: duration's ctor binds by reference
+        return SimSeconds(step);
+    }
+    float GetAlpha() const { return m_accumulator.count() / STEP_SECONDS; }
+    int GetLastStepCount() const { return m_lastStepCount; }
+
+private:
+    SimSeconds m_accumulator;
+    int m_lastStepCount;
+};
@@ -0,0 +1,36 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "SimClock.h"
+
+SELFTEST_CASE(SimClock_SixtyHertzFrameRunsTwoSteps) {
+    FixedStepClock clock;
+    for (int frame = 0; frame < 600; frame++) {
+        clock.Advance(SimSeconds(1.0f / 60.0f));
+        if (!SELFTEST_CHECK(context, clock.GetLastStepCount() == 2)) {
+            context.Log("frame %d ran %d steps", frame, clock.GetLastStepCount());
+            return;
+        }
+    }
+    SELFTEST_CHECK(context, clock.GetAlpha() >= 0.0f && clock.GetAlpha() < 1.0f);
+}
+
+SELFTEST_CASE(SimClock_LongFrameIsCapped) {
+    FixedStepClock clock;
+    clock.Advance(SimSeconds(0.5f));
+    SELFTEST_CHECK(context, clock.GetLastStepCount() == FixedStepClock::MAX_STEPS_PER_FRAME);
+
+    // The stalled time is dropped rather than paid back on the next frames
+    SELFTEST_CHECK(context, clock.GetAlpha() < 1.0f);
+    clock.Advance(SimSeconds(1.0f / 60.0f));
+    SELFTEST_CHECK(context, clock.GetLastStepCount() == 2);
+}
+
+SELFTEST_CASE(SimClock_ShortFramesAccumulate) {
+    FixedStepClock clock;
+    int steps = 0;
+    for (int frame = 0; frame < 240; frame++) {
+        steps += clock.Advance(SimSeconds(1.0f / 240.0f));
+    }
+    // One second of 240Hz frames is 120 steps, give or take float rounding
+    SELFTEST_CHECK(context, steps >= 119 && steps <= 120);
+}
@@ -0,0 +1,130 @@
+#include "stdafx.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float width, float height, float cellSize) {
+    Reset(width, height, cellSize);
+}
+
+void SpatialGrid::Reset(float width, float height, float cellSize) {
+    m_cellSize = cellSize;
+    m_invCellSize = 1.0f / cellSize;
+    m_columns = static_cast<int>(ceilf(width * m_invCellSize));
+    m_rows = static_cast<int>(ceilf(height * m_invCellSize));
+    if (m_columns < 1) m_columns = 1;
+    if (m_rows < 1) m_rows = 1;
+
+    m_staticCells.assign(m_columns * m_rows, std::vector<int>());
+    m_dynamicCells.assign(m_columns * m_rows, std::vector<int>());
+    m_marks.clear();
+    m_stamp = 0;
+}
+
+void SpatialGrid::InsertStatic(int id, float left, float top, float right, float bottom) {
+    Insert(m_staticCells, id, left, top, right, bottom);
+}
+
+void SpatialGrid::InsertDynamic(int id, float left, float top, float right, float bottom) {
+    Insert(m_dynamicCells, id, left, top, right, bottom);
+}
+
+void SpatialGrid::ClearStatic() {
+    // Keep each cell's capacity; the same level is rebuilt into the same cells
+    for (auto& cell : m_staticCells) cell.clear();
+}
+
+void SpatialGrid::ClearDynamic() {
+    for (auto& cell : m_dynamicCells) cell.clear();
+}
+
+void SpatialGrid::RemoveStatic(int id, float left, float top, float right, float bottom) {
+    if (m_columns == 0) return;
+
+    int col0, row0, col1, row1;
+    CellRange(left, top, right, bottom, col0, row0, col1, row1);
+    for (int row = row0; row <= row1; row++) {
+        for (int col = col0; col <= col1; col++) {
+            std::vector<int>& cell = m_staticCells[row * m_columns + col];
+            cell.erase(std::remove(cell.begin(), cell.end(), id), cell.end());
+        }
+    }
+}
+
+void SpatialGrid::RenameStatic(int from, int to, float left, float top, float right, float bottom) {
+    if (m_columns == 0) return;
+
+    int col0, row0, col1, row1;
+    CellRange(left, top, right, bottom, col0, row0, col1, row1);
+    for (int row = row0; row <= row1; row++) {
+        for (int col = col0; col <= col1; col++) {
+            std::vector<int>& cell = m_staticCells[row * m_columns + col];
+            std::replace(cell.begin(), cell.end(), from, to);
+        }
+    }
+}
+
+void SpatialGrid::Query(float left, float top, float right, float bottom, std::vector<int>& out) const {
+    QueryLayers(true, left, top, right, bottom, out);
+}
+
+void SpatialGrid::QueryDynamic(float left, float top, float right, float bottom, std::vector<int>& out) const {
+    QueryLayers(false, left, top, right, bottom, out);
+}
+
+void SpatialGrid::QueryLayers(bool includeStatic, float left, float top, float right, float bottom,
+                              std::vector<int>& out) const {
+    if (m_columns == 0) return;
+
+    int col0, row0, col1, row1;
+    CellRange(left, top, right, bottom, col0, row0, col1, row1);
+
+    if (++m_stamp == 0) {
+        // Stamp wrapped; old marks could collide with new stamps
+        std::fill(m_marks.begin(), m_marks.end(), 0u);
+        m_stamp = 1;
+    }
+
+    const std::vector<std::vector<int>>* layers[] = { &m_staticCells, &m_dynamicCells };
+    for (const auto* layer : layers) {
+        if (layer == &m_staticCells && !includeStatic) continue;
+        for (int row = row0; row <= row1; row++) {
+            for (int col = col0; col <= col1; col++) {
+                for (int id : (*layer)[row * m_columns + col]) {
+                    if (m_marks[id] == m_stamp) continue;
+                    m_marks[id] = m_stamp;
+                    out.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::CellRange(float left, float top, float right, float bottom,
+                            int& col0, int& row0, int& col1, int& row1) const {
+    col0 = static_cast<int>(floorf(left * m_invCellSize));
+    row0 = static_cast<int>(floorf(top * m_invCellSize));
+    col1 = static_cast<int>(floorf(right * m_invCellSize));
+    row1 = static_cast<int>(floorf(bottom * m_invCellSize));
+
+    col0 = std::max(0, std::min(col0, m_columns - 1));
+    col1 = std::max(0, std::min(col1, m_columns - 1));
+    row0 = std::max(0, std::min(row0, m_rows - 1));
+    row1 = std::max(0, std::min(row1, m_rows - 1));
+}
+
+void SpatialGrid::Insert(std::vector<std::vector<int>>& layer, int id, float left, float top, float right, float bottom) {
+    if (m_columns == 0 || id < 0) return;
+
+    if (id >= static_cast<int>(m_marks.size())) {
+        m_marks.resize(id + 1, 0u);
+    }
+
+    int col0, row0, col1, row1;
+    CellRange(left, top, right, bottom, col0, row0, col1, row1);
+    for (int row = row0; row <= row1; row++) {
+        for (int col = col0; col <= col1; col++) {
+            layer[row * m_columns + col].push_back(id);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+
+// Uniform grid over the play area for broadphase queries. Objects are
+// referred to by small dense integer ids chosen by the caller; an object is
+// listed in every cell its bounding box touches. Positions outside the grid
+// clamp to the edge cells.
+//
+// Two layers: static entries (walls, pickups) are inserted once, dynamic
+// entries (enemies, balls) are cleared and re-inserted every tick.
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+    SpatialGrid(float width, float height, float cellSize);
+
+    void Reset(float width, float height, float cellSize);
+
+    void InsertStatic(int id, float left, float top, float right, float bottom);
+    void InsertDynamic(int id, float left, float top, float right, float bottom);
+    void ClearStatic();
+    void ClearDynamic();
+
+    // Static entries carry no bounds of their own, so these take the box the
+    // id was inserted with. RenameStatic moves `from`'s entries over to `to`.
+    void RemoveStatic(int id, float left, float top, float right, float bottom);
+    void RenameStatic(int from, int to, float left, float top, float right, float bottom);
+
+    // Appends every id whose cells overlap the box, each id once. Not
+    // thread-safe: the de-duplication marks live in the grid.
+    void Query(float left, float top, float right, float bottom, std::vector<int>& out) const;
+    void QueryDynamic(float left, float top, float right, float bottom, std::vector<int>& out) const;
+
+    float GetCellSize() const { return m_cellSize; }
+    int GetColumns() const { return m_columns; }
+    int GetRows() const { return m_rows; }
+
+private:
+    void CellRange(float left, float top, float right, float bottom,
+                   int& col0, int& row0, int& col1, int& row1) const;
+    void Insert(std::vector<std::vector<int>>& layer, int id, float left, float top, float right, float bottom);
+    void QueryLayers(bool includeStatic, float left, float top, float right, float bottom, std::vector<int>& out) const;
+
+    float m_cellSize = 64.0f;
+    float m_invCellSize = 1.0f / 64.0f;
+    int m_columns = 0;
+    int m_rows = 0;
+    std::vector<std::vector<int>> m_staticCells;
+    std::vector<std::vector<int>> m_dynamicCells;
+
+    // Query de-duplication: an id is reported when its mark differs from the stamp
+    mutable std::vector<unsigned> m_marks;
+    mutable unsigned m_stamp = 0;
+};
@@ -0,0 +1,409 @@
+#include "stdafx.h"
+#include "TemplateLibrary.h"
+#include "MappedFile.h"
+#include <cmath>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// The scanners below don't look for the end of the text: Parse only gives
+// them text that ends in '\n', and every one of them stops there. Those
+// that compare or load several bytes at once take `end` to stay inside.
+namespace {
+    const float FLOAT_POWERS_OF_TEN[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+    const uint64_t INTEGER_POWERS_OF_TEN[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+    const double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    bool IsSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // What may follow a word or a number
+    bool IsDelimiter(char c) {
+        return IsSpace(c) || c == '\n' || c == '#';
+    }
+
+    void SkipSpaces(const char*& p) {
+        while (IsSpace(*p)) p++;
+    }
+
+    // Past the '\n' that ends the line `p` is on
+    void SkipLine(const char*& p, const char* end) {
+        if (*p != '\n') p = static_cast<const char*>(memchr(p, '\n', end - p));
+        p++;
+    }
+
+    // Next whitespace-separated word; empty at the end of the line or a comment
+    void ReadWord(const char*& p, const char*& word, size_t& length) {
+        SkipSpaces(p);
+        word = p;
+        while (!IsDelimiter(*p)) p++;
+        length = static_cast<size_t>(p - word);
+    }
+
+    template<size_t N>
+    bool WordIs(const char* word, size_t length, const char (&keyword)[N]) {
+        return length == N - 1 && memcmp(word, keyword, N - 1) == 0;
+    }
+
+    // None: a blank or comment line
+    enum class Keyword { None, Unknown, Template, End, Variation, Start, Hole, Wall, Collectible, Enemy, Cell };
+
+    // Whether the word at `p` is `keyword`; steps past it if so
+    template<size_t N>
+    bool MatchWord(const char*& p, const char* end, const char (&keyword)[N]) {
+        if (end - p < static_cast<ptrdiff_t>(N) || memcmp(p, keyword, N - 1) != 0 || !IsDelimiter(p[N - 1])) return false;
+        p += N - 1;
+        return true;
+    }
+
+    // Reads the keyword that starts a line, choosing on its first letter
+    // rather than reading the word and then comparing it with each keyword
+    Keyword ReadKeyword(const char*& p, const char* end) {
+        SkipSpaces(p);
+        switch (*p) {
+        case 'w': if (MatchWord(p, end, "wall")) return Keyword::Wall; break;
+        case 'c':
+            if (MatchWord(p, end, "collectible")) return Keyword::Collectible;
+            if (MatchWord(p, end, "cell")) return Keyword::Cell;
+            break;
+        case 'e':
+            if (MatchWord(p, end, "enemy")) return Keyword::Enemy;
+            if (MatchWord(p, end, "end")) return Keyword::End;
+            break;
+        case 's': if (MatchWord(p, end, "start")) return Keyword::Start; break;
+        case 'h': if (MatchWord(p, end, "hole")) return Keyword::Hole; break;
+        case 't': if (MatchWord(p, end, "template")) return Keyword::Template; break;
+        case 'v': if (MatchWord(p, end, "variation")) return Keyword::Variation; break;
+        case '\n':
+        case '#':
+            return Keyword::None;
+        }
+        return Keyword::Unknown;
+    }
+
+    // [+-]digits[.digits][e[+-]digits], without strtof's locale lookups. Up
+    // to 19 significant digits are kept exactly and scaled by an exact power
+    // of ten, so anything printed with %.9g reads back as the same float.
+    bool ParseLongFloat(const char*& p, float& out) {
+        const char* s = p;
+        bool negative = false;
+        if (*s == '-' || *s == '+') {
+            negative = *s == '-';
+            s++;
+        }
+
+        uint64_t mantissa = 0;
+        int significant = 0;
+        int exponent = 0;
+        bool anyDigits = false;
+        for (; IsDigit(*s); s++) {
+            anyDigits = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*s - '0');
+                if (mantissa > 0) significant++;
+            } else {
+                exponent++;
+            }
+        }
+        if (*s == '.') {
+            for (s++; IsDigit(*s); s++) {
+                anyDigits = true;
+                if (significant < 19) {
+                    mantissa = mantissa * 10 + (*s - '0');
+                    if (mantissa > 0) significant++;
+                    exponent--;
+                }
+            }
+        }
+        if (!anyDigits) return false;
+
+        if (*s == 'e' || *s == 'E') {
+            s++;
+            bool negativeExponent = false;
+            if (*s == '-' || *s == '+') {
+                negativeExponent = *s == '-';
+                s++;
+            }
+            if (!IsDigit(*s)) return false;
+            int value = 0;
+            for (; IsDigit(*s); s++) {
+                if (value < 1000) value = value * 10 + (*s - '0');
+            }
+            exponent += negativeExponent ? -value : value;
+        }
+        if (!IsDelimiter(*s)) return false;
+
+        double value = static_cast<double>(mantissa);
+        if (exponent >= 0 && exponent <= 22) {
+            value *= POWERS_OF_TEN[exponent];
+        } else if (exponent < 0 && exponent >= -22) {
+            value /= POWERS_OF_TEN[-exponent];
+        } else {
+            value *= pow(10.0, exponent);
+        }
+        out = static_cast<float>(negative ? -value : value);
+        p = s;
+        return true;
+    }
+
+    int CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    // Appends the run of digits at `s` to `mantissa`. The first eight bytes
+    // are checked and converted together (first byte lowest, as x86 loads
+    // them), so a run of up to eight costs no branch on its length; longer
+    // runs, and the last few bytes of the text, go a byte at a time.
+    void ReadDigits(const char*& s, const char* end, uint64_t& mantissa) {
+        if (end - s >= 8) {
+            uint64_t word;
+            memcpy(&word, s, sizeof(word));
+            // Top bit of each byte that isn't '0'-'9'
+            const uint64_t x = word ^ 0x3030303030303030ull;
+            const uint64_t nonDigits = (((x & 0x7F7F7F7F7F7F7F7Full) + 0x7676767676767676ull) | x) & 0x8080808080808080ull;
+            const int count = nonDigits ? CountTrailingZeros(nonDigits) / 8 : 8;
+            if (count > 0) {
+                // Shift out the bytes past the digits so they read as leading
+                // zeros, then combine pairs, quads and halves
+                word = (word & 0x0F0F0F0F0F0F0F0Full) << (8 * (8 - count));
+                word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFull;
+                word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFull;
+                word = (word * 10000 + (word >> 32)) & 0xFFFFFFFFull;
+                mantissa = mantissa * INTEGER_POWERS_OF_TEN[count] + word;
+                s += count;
+            }
+        }
+        for (; IsDigit(*s); s++) {
+            mantissa = mantissa * 10 + (*s - '0');
+        }
+    }
+
+    // What a template file holds: [+-]digits[.digits] with 19 digits or
+    // fewer. Fractions are where the length varies (0.5, 0.35000002), so
+    // they go through ReadDigits; integer parts are mostly a digit or three
+    // and are cheaper byte by byte. Anything longer or with an exponent goes
+    // to ParseLongFloat.
+    bool ParseFloat(const char*& p, const char* end, float& out) {
+        const char* s = p;
+        bool negative = false;
+        if (*s == '-' || *s == '+') {
+            negative = *s == '-';
+            s++;
+        }
+
+        uint64_t mantissa = 0;
+        const char* integer = s;
+        for (; IsDigit(*s); s++) {
+            mantissa = mantissa * 10 + (*s - '0');
+        }
+        int digits = static_cast<int>(s - integer);
+        int fractionDigits = 0;
+        if (*s == '.') {
+            const char* fraction = ++s;
+            ReadDigits(s, end, mantissa);
+            fractionDigits = static_cast<int>(s - fraction);
+            digits += fractionDigits;
+        }
+        if (digits == 0 || digits > 19 || *s == 'e' || *s == 'E') return ParseLongFloat(p, out);
+        if (!IsDelimiter(*s)) return false;
+
+        // Under 2^24 the mantissa and the power of ten are both exact floats,
+        // so a single float division rounds straight to the nearest float
+        float value;
+        if (mantissa < (1u << 24) && fractionDigits <= 10) {
+            value = static_cast<float>(mantissa) / FLOAT_POWERS_OF_TEN[fractionDigits];
+        } else {
+            value = static_cast<float>(static_cast<double>(mantissa) / POWERS_OF_TEN[fractionDigits]);
+        }
+        out = negative ? -value : value;
+        p = s;
+        return true;
+    }
+
+    // Reads the rest of the line as numbers; -1 if something else is there
+    // or there are more than `maxCount`
+    int ReadNumbers(const char*& p, const char* end, float* values, int maxCount) {
+        int count = 0;
+        for (;;) {
+            SkipSpaces(p);
+            if (*p == '\n' || *p == '#') return count;
+            if (count == maxCount || !ParseFloat(p, end, values[count])) return -1;
+            count++;
+        }
+    }
+}
+
+bool TemplateLibrary::Parse(const char* text, size_t length, TemplateSet& out, std::string& error) {
+    // A file saved without a final newline is copied once to get one
+    if (length > 0 && text[length - 1] != '\n') {
+        const std::string terminated = std::string(text, length) + '\n';
+        return Parse(terminated.data(), terminated.size(), out, error);
+    }
+
+    out.clear();
+    const char* p = text;
+    const char* const end = text + length;
+    int line = 0;
+    // Items collect in `scratch`, whose vectors keep their capacity from one
+    // template to the next; 'end' copies it out at its final size
+    CourseTemplate scratch;
+    CourseTemplate* current = nullptr;
+    bool hasStart = false;
+    bool hasHole = false;
+
+    auto fail = [&](const char* message) {
+        error = "line " + std::to_string(line) + ": " + message;
+        out.clear();
+        return false;
+    };
+
+    for (; p < end; SkipLine(p, end)) {
+        line++;
+        const Keyword kind = ReadKeyword(p, end);
+        if (kind == Keyword::None) continue;
+        if (kind == Keyword::Template) {
+            // The name is for people reading the file
+            if (current) return fail("'template' inside a template; missing 'end'?");
+            current = &scratch;
+            current->walls.clear();
+            current->collectibles.clear();
+            current->enemies.clear();
+            current->cells.clear();
+            current->startX = current->startY = 0.0f;
+            current->holeX = current->holeY = 0.0f;
+            current->variation = TemplateVariation::None;
+            hasStart = false;
+            hasHole = false;
+            continue;
+        }
+        if (!current) return fail("expected 'template'");
+
+        if (kind == Keyword::End) {
+            if (!hasStart || !hasHole) return fail("template needs a 'start' and a 'hole'");
+            out.push_back(*current);
+            current = nullptr;
+            continue;
+        }
+
+        if (kind == Keyword::Variation) {
+            const char* word;
+            size_t wordLength;
+            ReadWord(p, word, wordLength);
+            if (WordIs(word, wordLength, "none")) {
+                current->variation = TemplateVariation::None;
+            } else if (WordIs(word, wordLength, "grid")) {
+                current->variation = TemplateVariation::GridWalls;
+            } else if (WordIs(word, wordLength, "pinball")) {
+                current->variation = TemplateVariation::PinballObstacles;
+            } else {
+                return fail("variation must be none, grid or pinball");
+            }
+            continue;
+        }
+
+        float values[5];
+        const int count = ReadNumbers(p, end, values, 5);
+        switch (kind) {
+        case Keyword::Wall:
+            if (count != 4 && count != 5) return fail("wall takes x y width height [rotation]");
+            current->walls.push_back({ values[0], values[1], values[2], values[3], count == 5 ? values[4] : 0.0f });
+            break;
+        case Keyword::Start:
+            if (count != 2) return fail("start takes x y");
+            current->startX = values[0];
+            current->startY = values[1];
+            hasStart = true;
+            break;
+        case Keyword::Hole:
+            if (count != 2) return fail("hole takes x y");
+            current->holeX = values[0];
+            current->holeY = values[1];
+            hasHole = true;
+            break;
+        case Keyword::Collectible:
+            if (count != 2) return fail("collectible takes x y");
+            current->collectibles.push_back(std::make_pair(values[0], values[1]));
+            break;
+        case Keyword::Enemy:
+            if (count != 2) return fail("enemy takes x y");
+            current->enemies.push_back(std::make_pair(values[0], values[1]));
+            break;
+        case Keyword::Cell:
+            if (count != 2) return fail("cell takes x y");
+            current->cells.push_back(std::make_pair(values[0], values[1]));
+            break;
+        default:
+            return fail("unknown keyword");
+        }
+    }
+
+    if (current) return fail("missing 'end' at end of file");
+    return true;
+}
+
+TemplateLibrary::FileStamp TemplateLibrary::GetFileStamp(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return FileStamp{ 0, 0 };
+    return FileStamp{ static_cast<long long>(info.st_mtime), static_cast<long long>(info.st_size) };
+}
+
+bool TemplateLibrary::Load(const std::string& path) {
+    m_path = path;
+    m_stamp = GetFileStamp(path);
+    return Reload();
+}
+
+bool TemplateLibrary::PollForChanges() {
+    if (m_path.empty()) return false;
+
+    // Editors that save in two writes can show a half-written file; it fails
+    // to parse, and the second write changes the stamp again
+    FileStamp stamp = GetFileStamp(m_path);
+    if (stamp == m_stamp) return false;
+    m_stamp = stamp;
+    return Reload();
+}
+
+bool TemplateLibrary::Reload() {
+    MappedFile file;
+    if (!file.Open(m_path.c_str())) {
+        m_lastError = "can't read " + m_path;
+        return false;
+    }
+
+    TemplateSet templates;
+    std::string error;
+    if (!Parse(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), templates, error)) {
+        m_lastError = m_path + ", " + error;
+        return false;
+    }
+    if (templates.empty()) {
+        m_lastError = m_path + " has no templates";
+        return false;
+    }
+
+    std::shared_ptr<const TemplateSet> published = std::make_shared<TemplateSet>(std::move(templates));
+    std::atomic_store(&m_templates, published);
+    m_generation++;
+    m_lastError.clear();
+    return true;
+}
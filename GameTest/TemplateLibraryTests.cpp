@@ -0,0 +1,219 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "TemplateLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <string>
+
+namespace {
+    // One item line, each float in the shortest form that reads back
+    // exactly, as Courses.txt has them
+    void AppendItem(std::string& text, const char* keyword, std::initializer_list<float> values) {
+        text += keyword;
+        for (float value : values) {
+            char number[32];
+            for (int precision = 6; precision <= 9; precision++) {
+                snprintf(number, sizeof(number), "%.*g", precision, value);
+                if (strtof(number, nullptr) == value) break;
+            }
+            text += ' ';
+            text += number;
+        }
+        text += '\n';
+    }
+
+    // The built-in table as Courses.txt spells it
+    void AppendTemplate(std::string& text, const CourseTable& table, int index) {
+        static const char* const VARIATIONS[] = { "none", "grid", "pinball" };
+        text += "# Built-in template " + std::to_string(index) + "\n";
+        text += "template builtin" + std::to_string(index) + "\n";
+        AppendItem(text, "start", { table.startX, table.startY });
+        AppendItem(text, "hole", { table.holeX, table.holeY });
+        for (int i = 0; i < table.wallCount; i++) {
+            const WallTemplate& wall = table.walls[i];
+            if (wall.rotation != 0.0f) {
+                AppendItem(text, "wall", { wall.relativeX, wall.relativeY, wall.width, wall.height, wall.rotation });
+            } else {
+                AppendItem(text, "wall", { wall.relativeX, wall.relativeY, wall.width, wall.height });
+            }
+        }
+        for (int i = 0; i < table.collectibleCount; i++) {
+            AppendItem(text, "collectible", { table.collectibles[i].x, table.collectibles[i].y });
+        }
+        for (int i = 0; i < table.enemyCount; i++) {
+            AppendItem(text, "enemy", { table.enemies[i].x, table.enemies[i].y });
+        }
+        text += "variation " + std::string(VARIATIONS[static_cast<int>(table.variation)]) + "\n";
+        for (int i = 0; i < table.cellCount; i++) {
+            AppendItem(text, "cell", { table.cells[i].x, table.cells[i].y });
+        }
+        text += "end\n\n";
+    }
+
+    std::string MakeLibraryText(int templates) {
+        std::string text;
+        for (int i = 0; i < templates; i++) {
+            AppendTemplate(text, CourseTemplates::Get(i % CourseTemplates::COUNT), i % CourseTemplates::COUNT);
+        }
+        return text;
+    }
+
+    bool SameTemplate(const CourseTemplate& loaded, const CourseTable& table) {
+        if (loaded.startX != table.startX || loaded.startY != table.startY ||
+            loaded.holeX != table.holeX || loaded.holeY != table.holeY || loaded.variation != table.variation ||
+            loaded.walls.size() != static_cast<size_t>(table.wallCount) ||
+            loaded.collectibles.size() != static_cast<size_t>(table.collectibleCount) ||
+            loaded.enemies.size() != static_cast<size_t>(table.enemyCount) ||
+            loaded.cells.size() != static_cast<size_t>(table.cellCount)) {
+            return false;
+        }
+        for (int i = 0; i < table.wallCount; i++) {
+            if (memcmp(&loaded.walls[i], &table.walls[i], sizeof(WallTemplate)) != 0) return false;
+        }
+        for (int i = 0; i < table.collectibleCount; i++) {
+            if (loaded.collectibles[i].first != table.collectibles[i].x || loaded.collectibles[i].second != table.collectibles[i].y) return false;
+        }
+        for (int i = 0; i < table.enemyCount; i++) {
+            if (loaded.enemies[i].first != table.enemies[i].x || loaded.enemies[i].second != table.enemies[i].y) return false;
+        }
+        for (int i = 0; i < table.cellCount; i++) {
+            if (loaded.cells[i].first != table.cells[i].x || loaded.cells[i].second != table.cells[i].y) return false;
+        }
+        return true;
+    }
+
+    bool Parse(const std::string& text, TemplateLibrary::TemplateSet& out, std::string& error) {
+        return TemplateLibrary::Parse(text.data(), text.size(), out, error);
+    }
+}
+
+// The built-in tables, printed the way Courses.txt holds them, read back exactly
+SELFTEST_CASE(TemplateLibrary_ReadsBuiltInTablesBack) {
+    TemplateLibrary::TemplateSet templates;
+    std::string error;
+    if (!SELFTEST_CHECK(context, Parse(MakeLibraryText(CourseTemplates::COUNT), templates, error))) {
+        context.Log("%s", error.c_str());
+        return;
+    }
+    if (!SELFTEST_CHECK(context, templates.size() == static_cast<size_t>(CourseTemplates::COUNT))) return;
+    for (int i = 0; i < CourseTemplates::COUNT; i++) {
+        SELFTEST_CHECK(context, SameTemplate(templates[i], CourseTemplates::Get(i)));
+    }
+}
+
+// Any float printed with %.9g parses to the same bits
+SELFTEST_CASE(TemplateLibrary_FloatsReadBackExactly) {
+    const int VALUES = 20000;
+    std::mt19937 rng(22);
+    std::uniform_real_distribution<float> small(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> large(-5000.0f, 5000.0f);
+    std::uniform_int_distribution<uint32_t> bits(0u, 0xFFFFFFFFu);
+
+    int mismatches = 0;
+    for (int i = 0; i < VALUES; i++) {
+        float expected;
+        switch (i % 3) {
+        case 0:  expected = small(rng); break;
+        case 1:  expected = large(rng); break;
+        default: {
+            // Any finite bit pattern, denormals included
+            const uint32_t pattern = bits(rng);
+            memcpy(&expected, &pattern, sizeof(expected));
+            if (!std::isfinite(expected)) expected = 1.0f;
+        }
+        }
+        char text[128];
+        snprintf(text, sizeof(text), "template t\nstart %.9g 0\nhole 0 0\nend\n", expected);
+        TemplateLibrary::TemplateSet templates;
+        std::string error;
+        if (!TemplateLibrary::Parse(text, strlen(text), templates, error) || templates.size() != 1 ||
+            memcmp(&templates[0].startX, &expected, sizeof(expected)) != 0) {
+            if (mismatches++ < 5) context.Log("%.9g doesn't read back", expected);
+        }
+    }
+
+    // Longer than 19 digits, or with an exponent: the careful path
+    const char* const longForms[] = {
+        "123456789012345678901234", "0.00000000000000000000000123456", "3.14159265358979323846264",
+        "1.5e3", "-2.5E-2", "+7", "6.02214076e23", "1e-45",
+    };
+    for (const char* number : longForms) {
+        const std::string text = std::string("template t\nstart ") + number + " 0\nhole 0 0\nend\n";
+        TemplateLibrary::TemplateSet templates;
+        std::string error;
+        const float expected = strtof(number, nullptr);
+        if (!TemplateLibrary::Parse(text.data(), text.size(), templates, error) || templates.size() != 1 ||
+            memcmp(&templates[0].startX, &expected, sizeof(expected)) != 0) {
+            if (mismatches++ < 5) context.Log("%s doesn't read as %.9g", number, expected);
+        }
+    }
+    SELFTEST_CHECK(context, mismatches == 0);
+}
+
+SELFTEST_CASE(TemplateLibrary_ErrorsNameTheLine) {
+    const struct {
+        const char* text;
+        const char* error;
+    } cases[] = {
+        { "template a\nstart 0 0\nhole 1 1\n", "line 3: missing 'end' at end of file" },
+        { "start 0 0\n", "line 1: expected 'template'" },
+        { "template a\nstart 0\nhole 1 1\nend\n", "line 2: start takes x y" },
+        { "template a\nstart 0 0\nhole 1 1\nwall 0 0 1\nend\n", "line 4: wall takes x y width height [rotation]" },
+        { "template a\nstart 0 0\nhole 1 1x\nend\n", "line 3: hole takes x y" },
+        { "template a\nstart 0 0\nhole 1 1\nvariation maze\nend\n", "line 4: variation must be none, grid or pinball" },
+        { "template a\nstart 0 0\nend\n", "line 3: template needs a 'start' and a 'hole'" },
+        { "template a\n# comment\n\nstart 0 0\nhole 1 1\nbumper 0 0\nend\n", "line 6: unknown keyword" },
+    };
+    for (const auto& test : cases) {
+        TemplateLibrary::TemplateSet templates;
+        std::string error;
+        const bool parsed = TemplateLibrary::Parse(test.text, strlen(test.text), templates, error);
+        if (!SELFTEST_CHECK(context, !parsed && templates.empty() && error == test.error)) {
+            context.Log("expected \"%s\", got \"%s\"", test.error, error.c_str());
+        }
+    }
+}
+
+// The scanners stop at the '\n' that ends the text; a file saved without
+// one reads the same
+SELFTEST_CASE(TemplateLibrary_LastLineNeedsNoNewline) {
+    const char* const text = "template a\nstart 0 0\nhole 1 0.25\nend";
+    TemplateLibrary::TemplateSet templates;
+    std::string error;
+    if (SELFTEST_CHECK(context, TemplateLibrary::Parse(text, strlen(text), templates, error) && templates.size() == 1)) {
+        SELFTEST_CHECK(context, templates[0].holeX == 1.0f && templates[0].holeY == 0.25f);
+    }
+
+    // Cut short in the middle of a number: the line still ends there
+    const char* const cut = "template a\nstart 0 0\nhole 1 0.25";
+    SELFTEST_CHECK(context, !TemplateLibrary::Parse(cut, strlen(cut), templates, error) && templates.empty());
+    SELFTEST_CHECK(context, error == "line 3: missing 'end' at end of file");
+}
+
+// Best of 100 parses of the built-in set repeated. A couple of hundred
+// templates parse in about a third of a millisecond, 500 in a little under
+// one (see TemplateLibrary::Parse).
+SELFTEST_BENCHMARK(TemplateLibrary_ParseHundredsOfTemplates) {
+    const int counts[] = { 100, 200, 500 };
+    const int REPEATS = 100;
+    for (int count : counts) {
+        const std::string text = MakeLibraryText(count);
+        TemplateLibrary::TemplateSet templates;
+        std::string error;
+        double bestMs = 1e9;
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            const auto start = std::chrono::steady_clock::now();
+            const bool parsed = Parse(text, templates, error);
+            bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            if (!SELFTEST_CHECK(context, parsed && templates.size() == static_cast<size_t>(count))) return;
+        }
+        context.Log("%d templates, %.0f KB: %.3f ms, %.0f MB/s",
+                    count, text.size() / 1024.0, bestMs, text.size() / (bestMs * 1000.0));
+    }
+}
@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned threadCount) : m_stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 2;
+    }
+
+    for (unsigned i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskReady.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskReady.notify_one();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& body) {
+    if (count <= 0) return;
+
+    // Workers pull indices from a shared counter, so uneven items balance out
+    // without one task per item.
+    std::atomic<int> nextIndex(0);
+    int chunks = static_cast<int>(m_workers.size());
+    if (chunks > count) chunks = count;
+
+    std::mutex doneMutex;
+    std::condition_variable doneSignal;
+    int remainingChunks = chunks;
+
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        Submit([&]() {
+            for (int i = nextIndex++; i < count; i = nextIndex++) {
+                body(i);
+            }
+
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remainingChunks == 0) {
+                doneSignal.notify_one();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneSignal.wait(lock, [&]() { return remainingChunks == 0; });
+}
+
+void ThreadPool::WorkerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskReady.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
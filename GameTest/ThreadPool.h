@@ -0,0 +1,40 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads fed from a single task queue. Used for batch
+// work that doesn't touch App/GL state (shot simulation, level generation).
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = 0);  // 0 = one per hardware thread
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& GetInstance() {
+        static ThreadPool instance;
+        return instance;
+    }
+
+    void Submit(std::function<void()> task);
+
+    // Runs body(i) for every i in [0, count) across the workers and blocks
+    // until all of them have finished. Don't call from inside a pool task.
+    void ParallelFor(int count, const std::function<void(int)>& body);
+
+    unsigned GetThreadCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskReady;
+    bool m_stopping;
+};
@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "TrajectoryCache.h"
+#include "Level.h"
+#include <cmath>
+
+namespace {
+    const float ANGLE_STEPS_PER_RADIAN = 1800.0f / 3.14159265f;   // 0.1 degree
+    const float POWER_STEPS_PER_UNIT = 4.0f;
+    const float POSITION_STEPS_PER_PIXEL = 10.0f;
+    const float SPEED_STEPS_PER_UNIT = 1000.0f;
+}
+
+TrajectoryCache::TrajectoryCache(int maxContacts) : m_maxContacts(maxContacts), m_key() {}
+
+bool TrajectoryCache::Key::operator==(const Key& other) const {
+    return level == other.level && version == other.version &&
+           angle == other.angle && power == other.power &&
+           x == other.x && y == other.y && speedMultiplier == other.speedMultiplier &&
+           phaseMode == other.phaseMode && enemyImmune == other.enemyImmune;
+}
+
+bool TrajectoryCache::Key::SameStart(const Key& other) const {
+    return level == other.level && version == other.version &&
+           x == other.x && y == other.y && speedMultiplier == other.speedMultiplier &&
+           phaseMode == other.phaseMode && enemyImmune == other.enemyImmune;
+}
+
+TrajectoryCache::Key TrajectoryCache::MakeKey(const Level& level, float startX, float startY,
+                                              float power, float angle) const {
+    Key key;
+    key.level = &level;
+    key.version = level.GetVersion();
+    key.angle = static_cast<int>(lroundf(angle * ANGLE_STEPS_PER_RADIAN));
+    key.power = static_cast<int>(lroundf(power * POWER_STEPS_PER_UNIT));
+    key.x = static_cast<int>(lroundf(startX * POSITION_STEPS_PER_PIXEL));
+    key.y = static_cast<int>(lroundf(startY * POSITION_STEPS_PER_PIXEL));
+
+    const Ball* ball = level.GetBall();
+    key.speedMultiplier = ball ? static_cast<int>(lroundf(ball->GetSpeedMultiplier() * SPEED_STEPS_PER_UNIT)) : 0;
+    key.phaseMode = ball && ball->IsPhaseMode();
+    key.enemyImmune = ball && ball->IsEnemyImmune();
+    return key;
+}
+
+const ShotSimulator::ShotOutcome* TrajectoryCache::Get(const Level& level, float startX, float startY,
+                                                       float power, float angle) {
+    m_stats.lookups++;
+
+    Key key = MakeKey(level, startX, startY, power, angle);
+    const bool enemiesMoved = m_hasPatrols && ++m_age >= ENEMY_REFRESH_LOOKUPS;
+    if (!m_valid || !(key == m_key)) {
+        const bool reuse = m_valid && m_snapshot && key.SameStart(m_key) && !enemiesMoved;
+        m_key = key;
+        m_valid = true;
+        Submit(level, startX, startY, power, angle, reuse);
+        m_stats.misses++;
+    } else if (enemiesMoved) {
+        Submit(level, startX, startY, power, angle, false);
+        m_stats.refreshes++;
+    } else {
+        m_stats.hits++;
+    }
+
+    m_latest = m_predictor.Latest();
+    if (m_latest && m_latest->refined && m_latest->sequence != m_lastRefined) {
+        m_lastRefined = m_latest->sequence;
+        m_stats.refinements++;
+    }
+    return m_latest ? &m_latest->outcome : nullptr;
+}
+
+void TrajectoryCache::Submit(const Level& level, float startX, float startY, float power, float angle,
+                             bool reuseSnapshot) {
+    if (!reuseSnapshot) {
+        auto snapshot = std::make_shared<LevelSnapshot>(level.CreateSnapshot());
+        snapshot->ball.x = startX;
+        snapshot->ball.y = startY;
+        m_stats.snapshots++;
+
+        m_hasPatrols = false;
+        for (const EnemySnapshot& enemy : snapshot->enemies) {
+            if (enemy.active && enemy.patrol.pattern != PatrolPattern::Stationary) {
+                m_hasPatrols = true;
+                break;
+            }
+        }
+        m_age = 0;
+        m_snapshot = std::move(snapshot);
+    }
+
+    // The predictor only reads the snapshot, so it can share ours
+    m_pending = m_predictor.Submit(m_snapshot, power, angle, m_maxContacts);
+}
+
+bool TrajectoryCache::IsRefined() const {
+    return m_valid && m_latest && m_latest->sequence == m_pending && m_latest->refined;
+}
+
+float TrajectoryCache::GetHitRate() const {
+    return m_stats.lookups > 0 ? static_cast<float>(m_stats.hits) / m_stats.lookups : 0.0f;
+}
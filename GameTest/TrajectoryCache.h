@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include "AimPredictor.h"
+
+class Level;
+
+// Decides when the aim preview needs re-simulating and hands that work to an
+// AimPredictor. Inputs are quantized into the key: aim to 0.1 degree, power to
+// a quarter of a drag unit, ball position to 0.1 px. The layout is covered by
+// Level::GetVersion. Patrolling enemies move without changing the key, so with
+// any about the path is re-run every ENEMY_REFRESH_LOOKUPS lookups.
+//
+// New aims at the same ball position reuse the last snapshot rather than
+// taking another; with patrols it is retaken once it is ENEMY_REFRESH_LOOKUPS
+// lookups old, the same staleness a hit already accepts.
+//
+// Progressive: the predictor publishes a coarse path for a new key first and
+// the full-resolution one after it.
+class TrajectoryCache {
+public:
+    static constexpr int ENEMY_REFRESH_LOOKUPS = 10;
+
+    struct Stats {
+        long long lookups;
+        long long hits;          // Key unchanged: nothing re-simulated
+        long long misses;        // New key submitted
+        long long refinements;   // Full-resolution paths received
+        long long refreshes;     // Same key, re-submitted because enemies moved
+        long long snapshots;     // Level::CreateSnapshot calls
+    };
+
+    explicit TrajectoryCache(int maxContacts = 5);
+
+    // Submits work if needed and returns the newest finished path, which may
+    // still be for an earlier aim; nullptr until the first one arrives.
+    const ShotSimulator::ShotOutcome* Get(const Level& level, float startX, float startY, float power, float angle);
+    void Invalidate() { m_valid = false; }
+
+    // The newest path is the full-resolution one for the current key
+    bool IsRefined() const;
+
+    const Stats& GetStats() const { return m_stats; }
+    float GetHitRate() const;
+    void ResetStats() { m_stats = Stats{ 0, 0, 0, 0, 0, 0 }; }
+    AimPredictor& GetPredictor() { return m_predictor; }
+
+private:
+    struct Key {
+        const Level* level;
+        uint32_t version;
+        int angle, power;
+        int x, y;
+        int speedMultiplier;
+        bool phaseMode, enemyImmune;
+
+        bool operator==(const Key& other) const;
+        // Everything but the aim: the snapshot is the same for both
+        bool SameStart(const Key& other) const;
+    };
+
+    Key MakeKey(const Level& level, float startX, float startY, float power, float angle) const;
+    void Submit(const Level& level, float startX, float startY, float power, float angle, bool reuseSnapshot);
+
+    int m_maxContacts;
+    bool m_valid = false;
+    Key m_key;
+    uint64_t m_pending = 0;         // Predictor sequence answering m_key
+    bool m_hasPatrols = false;
+    int m_age = 0;                  // Lookups since m_snapshot was taken
+    std::shared_ptr<const LevelSnapshot> m_snapshot;
+
+    AimPredictor m_predictor;
+    const AimPredictor::Result* m_latest = nullptr;
+    uint64_t m_lastRefined = 0;
+    Stats m_stats = { 0, 0, 0, 0, 0, 0 };
+};
@@ -0,0 +1,57 @@
+#include "stdafx.h"
+#include "SelfTest.h"
+#include "Collectible.h"
+#include "Level.h"
+#include "TrajectoryCache.h"
+#include "Wall.h"
+#include <memory>
+
+namespace {
+    // No patrolling enemies, so nothing but the key decides when to re-simulate
+    std::unique_ptr<Level> MakeStillLevel() {
+        std::unique_ptr<Level> level(new Level(3));
+        level->SetHole(std::unique_ptr<Hole>(new Hole(150.0f, 400.0f, 880.0f, 600.0f, 3)));
+        level->SetBall(std::unique_ptr<Ball>(new Ball(150.0f, 400.0f)));
+        level->EmplaceObject<Wall>(400.0f, 300.0f, 20.0f, 300.0f);
+        level->EmplaceObject<Wall>(650.0f, 500.0f, 240.0f, 20.0f, 30.0f);
+        level->EmplaceObject<Collectible>(500.0f, 120.0f);
+        return level;
+    }
+}
+
+// Holding the aim still is a hit every frame after the first
+SELFTEST_CASE(TrajectoryCache_SameAimHits) {
+    const int LOOKUPS = 20;
+    std::unique_ptr<Level> level = MakeStillLevel();
+    TrajectoryCache cache;
+    for (int i = 0; i < LOOKUPS; i++) {
+        cache.Get(*level, 150.0f, 400.0f, 60.0f, 0.3f);
+    }
+
+    const TrajectoryCache::Stats& stats = cache.GetStats();
+    context.Log("%lld lookups: %lld hits, %lld misses, %lld snapshots", stats.lookups, stats.hits, stats.misses, stats.snapshots);
+    SELFTEST_CHECK(context, stats.misses == 1 && stats.hits == LOOKUPS - 1);
+    SELFTEST_CHECK(context, stats.snapshots == 1 && stats.refreshes == 0);
+}
+
+// Sweeping the aim misses every lookup, but the level and the ball haven't
+// changed, so one snapshot serves them all. A layout change or a new ball
+// position takes a fresh one.
+SELFTEST_CASE(TrajectoryCache_NewAimsReuseSnapshot) {
+    const int AIMS = 30;
+    std::unique_ptr<Level> level = MakeStillLevel();
+    TrajectoryCache cache;
+    for (int i = 0; i < AIMS; i++) {
+        cache.Get(*level, 150.0f, 400.0f, 60.0f, 0.05f * i);
+    }
+    const TrajectoryCache::Stats& stats = cache.GetStats();
+    SELFTEST_CHECK(context, stats.misses == AIMS && stats.snapshots == 1);
+
+    level->EmplaceObject<Collectible>(300.0f, 120.0f);
+    cache.Get(*level, 150.0f, 400.0f, 60.0f, 0.0f);
+    SELFTEST_CHECK(context, stats.snapshots == 2);
+
+    cache.Get(*level, 160.0f, 400.0f, 60.0f, 0.0f);
+    SELFTEST_CHECK(context, stats.snapshots == 3);
+    context.Log("%lld lookups: %lld misses, %lld snapshots", stats.lookups, stats.misses, stats.snapshots);
+}
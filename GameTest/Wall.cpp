@@ -1,38 +1,29 @@
 #include "stdafx.h"
 #include "Wall.h"
 #include "Ball.h"
+#include "CollisionDispatch.h"
 
 void Wall::Draw() {
-    App::DrawLine(m_posX - m_width/2, m_posY - m_height/2, 
-                 m_posX + m_width/2, m_posY - m_height/2, 0.0f, 1.0f, 0.0f);
-    App::DrawLine(m_posX + m_width/2, m_posY - m_height/2,
-                 m_posX + m_width/2, m_posY + m_height/2, 0.0f, 1.0f, 0.0f);
-    App::DrawLine(m_posX + m_width/2, m_posY + m_height/2,
-                 m_posX - m_width/2, m_posY + m_height/2, 0.0f, 1.0f, 0.0f);
-    App::DrawLine(m_posX - m_width/2, m_posY + m_height/2,
-                 m_posX - m_width/2, m_posY - m_height/2, 0.0f, 1.0f, 0.0f);
+    // Corners in the wall's own frame, rotated into place
+    const float localX[4] = { -m_box.halfWidth, m_box.halfWidth, m_box.halfWidth, -m_box.halfWidth };
+    const float localY[4] = { -m_box.halfHeight, -m_box.halfHeight, m_box.halfHeight, m_box.halfHeight };
+    float cornerX[4], cornerY[4];
+    for (int i = 0; i < 4; i++) {
+        cornerX[i] = m_box.centerX + localX[i] * m_box.cosAngle - localY[i] * m_box.sinAngle;
+        cornerY[i] = m_box.centerY + localX[i] * m_box.sinAngle + localY[i] * m_box.cosAngle;
+    }
+    for (int i = 0; i < 4; i++) {
+        int next = (i + 1) % 4;
+        App::DrawLine(cornerX[i], cornerY[i], cornerX[next], cornerY[next], 0.0f, 1.0f, 0.0f);
+    }
 }
 
 bool Wall::CheckCollision(const GameObject& other) {
-    const Ball* ball = dynamic_cast<const Ball*>(&other);
-    if (!ball) return false;
-    
+    return CollisionDispatch::Collide(*this, other);
+}
+
+bool Wall::OverlapsBall(const Ball& ball) const {
     float ballX, ballY;
-    ball->GetPosition(ballX, ballY);
-    
-    // Calculate wall boundaries
-    float wallLeft = m_posX - m_width/2;
-    float wallRight = m_posX + m_width/2;
-    float wallTop = m_posY - m_height/2;
-    float wallBottom = m_posY + m_height/2;
-    
-    // Check if ball overlaps with wall boundaries
-    if (ballX + ball->GetRadius() > wallLeft && 
-        ballX - ball->GetRadius() < wallRight &&
-        ballY + ball->GetRadius() > wallTop && 
-        ballY - ball->GetRadius() < wallBottom) {
-        return true;
-    }
-    
-    return false;
+    ball.GetPosition(ballX, ballY);
+    return BallPhysics::CircleOverlapsBox(m_box, ballX, ballY, ball.GetRadius());
 }
@@ -1,25 +1,49 @@
 #pragma once
 #include "GameObject.h"
+#include "ObjectArena.h"
 #include "App/app.h"
+#include "BallPhysics.h"
 
 struct Vector2 {
     float x, y;
 };
 
+class Ball;
+
 class Wall : public GameObject {
+public:
+    static constexpr Type TYPE = Type::Wall;
+
 private:
     float m_width;
     float m_height;
+    float m_rotation;   // Degrees about the centre
+    BallPhysics::OrientedBox m_box;
 
 public:
-    Wall(float x, float y, float width, float height) 
-        : GameObject(x, y), m_width(width), m_height(height) {}
+    Wall(float x, float y, float width, float height, float rotation = 0.0f)
+        : GameObject(x, y, TYPE), m_width(width), m_height(height), m_rotation(rotation),
+          m_box(BallPhysics::MakeOrientedBox(x, y, width, height, rotation)) {}
     
-    void Update(float deltaTime) override {}
+    void Update(SimSeconds deltaTime) override {}
+    bool NeedsUpdate() const override { return false; }
     void Draw() override;
+    void SetPosition(float x, float y) override {
+        GameObject::SetPosition(x, y);
+        m_box.centerX = x;
+        m_box.centerY = y;
+    }
+    std::unique_ptr<GameObject> Clone() const override { return std::make_unique<Wall>(*this); }
+    GameObject* CloneInto(ObjectArena& arena) const override { return arena.Create<Wall>(*this); }
     bool CheckCollision(const GameObject& other) override;
+    bool OverlapsBall(const Ball& ball) const;
     
     float GetWidth() const { return m_width; }
     float GetHeight() const { return m_height; }
+    float GetRotation() const { return m_rotation; }
     Vector2 GetPosition() const { return Vector2{m_posX, m_posY}; }
+    const BallPhysics::OrientedBox& GetOrientedBox() const { return m_box; }
+
+    // Axis-aligned box around the (possibly rotated) wall, for the broadphase
+    BallPhysics::WallBox GetBounds() const { return BallPhysics::GetBoundingBox(m_box); }
 };
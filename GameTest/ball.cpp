@@ -1,22 +1,19 @@
 #include "stdafx.h"
 #include "ball.h"
 #include "Wall.h"
+#include "CollisionDispatch.h"
 #include <cmath>
 #include <limits>
 
 Ball::Ball(float x, float y) : 
-    GameObject(x, y),
+    GameObject(x, y, TYPE),
     m_prevPosX(x),
     m_prevPosY(y),
     m_velocityX(0.0f),
     m_velocityY(0.0f),
-    m_accelerationX(0.0f),
-    m_accelerationY(0.0f),
-    m_friction(0.075f),
-    m_isMoving(false),
-    m_radius(10.0f),
     m_mass(45.0f),
-    m_accumulator(0.0f),
+    m_radius(10.0f),
+    m_isMoving(false),
     m_speedMultiplier(1.0f),
     m_sizeMultiplier(1.0f),
     m_phaseMode(false),
@@ -26,69 +23,47 @@ Ball::Ball(float x, float y) :
     m_height = m_radius * 2;
 }
 
-void Ball::Update(float deltaTime) {
+// One simulation step. The caller (GameTest.cpp's FixedStepClock driver)
+// owns the accumulator; velocities are in pixels per second.
+void Ball::Update(SimSeconds deltaTime) {
     if (!m_isMoving) return;
 
-    const float FIXED_TIMESTEP = 1.0f / 60.0f;
-    const float MAX_VELOCITY = 25.0f;
-    
-    m_accumulator += deltaTime;
-    
-    while (m_accumulator >= FIXED_TIMESTEP) {
-        m_prevPosX = m_posX;
-        m_prevPosY = m_posY;
-        
-        // Apply velocity caps
-        float speed = sqrt(m_velocityX * m_velocityX + m_velocityY * m_velocityY);
-        if (speed > MAX_VELOCITY) {
-            float scale = MAX_VELOCITY / speed;
-            m_velocityX *= scale;
-            m_velocityY *= scale;
-        }
-        
-        // Apply friction
-        if (speed > 0.0f) {
-            float frictionMagnitude = m_friction * speed * speed * 0.05f;
-            float frictionX = -(m_velocityX / speed) * frictionMagnitude;
-            float frictionY = -(m_velocityY / speed) * frictionMagnitude;
-            
-            m_accelerationX = frictionX;
-            m_accelerationY = frictionY;
-        }
-        
-        // Update velocity and position
-        m_velocityX += m_accelerationX * FIXED_TIMESTEP;
-        m_velocityY += m_accelerationY * FIXED_TIMESTEP;
-        
-        // Update position
-        m_posX += m_velocityX * FIXED_TIMESTEP;
-        m_posY += m_velocityY * FIXED_TIMESTEP;
-        
-        // Handle screen boundary collisions
-        HandleBoundaryCollisions();
-        
-        // Check for stopping condition
-        float speedSquared = m_velocityX * m_velocityX + m_velocityY * m_velocityY;
-        if (speedSquared < 0.01f) {
-            Stop();
-        }
-        
-        m_accumulator -= FIXED_TIMESTEP;
+    m_prevPosX = m_posX;
+    m_prevPosY = m_posY;
+
+    BallPhysics::BallState state = GetPhysicsState();
+    if (m_integrator == BallPhysics::Integrator::Analytic && m_physicsWorld) {
+        BallPhysics::AdvanceAnalytic(state, *m_physicsWorld, deltaTime.count());
+    } else {
+        BallPhysics::StepFixed(state, m_physicsWorld ? *m_physicsWorld : GetScreenWorld(), deltaTime.count());
     }
+    ApplyPhysicsState(state);
 }
 
 void Ball::Draw() {
+    DrawInterpolated(1.0f);
+}
+
+void Ball::DrawInterpolated(float alpha) {
+    // Between fixed steps a moving ball is drawn part way along its last one,
+    // so it glides instead of jumping a whole step on some frames
+    float x = m_posX;
+    float y = m_posY;
+    if (m_isMoving) {
+        GetInterpolatedPosition(alpha, x, y);
+    }
+
     // Draw the ball with size based on sizeMultiplier
-    DrawCircle(m_posX, m_posY, m_radius, 1.0f, 1.0f, 1.0f, 1.0f);
+    DrawCircle(x, y, m_radius, 1.0f, 1.0f, 1.0f, 1.0f);
     
     // Optional: Visual indicator for active powerups
     if (m_phaseMode) {
         // Draw ghost effect
-        DrawCircle(m_posX, m_posY, m_radius + 2, 0.5f, 0.5f, 1.0f, 0.5f);
+        DrawCircle(x, y, m_radius + 2, 0.5f, 0.5f, 1.0f, 0.5f);
     }
     if (m_enemyImmune) {
         // Draw shield effect
-        DrawCircle(m_posX, m_posY, m_radius + 4, 1.0f, 0.5f, 0.0f, 0.5f);
+        DrawCircle(x, y, m_radius + 4, 1.0f, 0.5f, 0.0f, 0.5f);
     }
     
     // Display velocity information
@@ -106,130 +81,76 @@ void Ball::Draw() {
 }
 
 bool Ball::CheckCollision(const GameObject& other) {
-    // Handle wall collisions
-    if (const Wall* wall = dynamic_cast<const Wall*>(&other)) {
-        // Skip wall collisions if in phase mode
-        if (!m_phaseMode) {
-            HandleWallCollision(*wall);
-        }
+    return CollisionDispatch::Collide(*this, other);
+}
+
+bool Ball::HandleEnemyCollision(const Enemy& enemy) {
+    // Skip enemy collisions if immune, and ignore enemies that are already dying
+    if (m_enemyImmune || !enemy.IsAlive() || enemy.IsExploding()) return false;
+
+    float enemyX, enemyY;
+    enemy.GetPosition(enemyX, enemyY);
+    
+    float dx = m_posX - enemyX;
+    float dy = m_posY - enemyY;
+    float distanceSquared = dx * dx + dy * dy;
+    float minDistance = m_radius + enemy.GetSize();
+    
+    if (distanceSquared < minDistance * minDistance) {
+        // Bounce away from enemy
+        float angle = atan2(dy, dx);
+        m_velocityX = cos(angle) * BallPhysics::ENEMY_BOUNCE_SPEED;
+        m_velocityY = sin(angle) * BallPhysics::ENEMY_BOUNCE_SPEED;
+        m_isMoving = true;
         return true;
     }
+    return false;
+}
+
+bool Ball::HandleCollectibleCollision(Collectible& collectible) {
+    if (collectible.IsCollected()) return false;
+
+    float collectibleX, collectibleY;
+    collectible.GetPosition(collectibleX, collectibleY);
     
-    // Handle enemy collisions
-    if (const Enemy* enemy = dynamic_cast<const Enemy*>(&other)) {
-        // Skip enemy collisions if immune
-        if (!m_enemyImmune) {
-            float enemyX, enemyY;
-            enemy->GetPosition(enemyX, enemyY);
-            
-            float dx = m_posX - enemyX;
-            float dy = m_posY - enemyY;
-            float distanceSquared = dx * dx + dy * dy;
-            float minDistance = m_radius + 10.0f; // Assuming enemy radius is 10
-            
-            if (distanceSquared < minDistance * minDistance) {
-                // Bounce away from enemy
-                float angle = atan2(dy, dx);
-                float bounceSpeed = 0.5f;  // Adjust as needed
-                m_velocityX = cos(angle) * bounceSpeed;
-                m_velocityY = sin(angle) * bounceSpeed;
-                m_isMoving = true;
-                return true;
-            }
-        }
-    }
+    float dx = m_posX - collectibleX;
+    float dy = m_posY - collectibleY;
+    float distanceSquared = dx * dx + dy * dy;
+    float minDistance = m_radius + collectible.GetRadius();
     
-    // Handle collectible collisions
-    if (Collectible* collectible = const_cast<Collectible*>(dynamic_cast<const Collectible*>(&other))) {
-        if (!collectible->IsCollected()) {
-            float collectibleX, collectibleY;
-            collectible->GetPosition(collectibleX, collectibleY);
-            
-            float dx = m_posX - collectibleX;
-            float dy = m_posY - collectibleY;
-            float distanceSquared = dx * dx + dy * dy;
-            float minDistance = m_radius + 8.0f; // Collectible radius
-            
-            if (distanceSquared < minDistance * minDistance) {
-                collectible->Collect();
-                return true;
-            }
-        }
+    if (distanceSquared < minDistance * minDistance) {
+        collectible.Collect();
+        return true;
     }
-    
     return false;
 }
 
 void Ball::ApplyForce(float power, float angle) {
-    const float MAX_DRAG_LENGTH = 100.0f;
-    const float POWER_SCALE = 2.0f;
-    
-    // Normalize the power based on drag length and apply speed multiplier
-    float normalizedPower = (power / MAX_DRAG_LENGTH) * POWER_SCALE * m_speedMultiplier;
-    
     // Apply velocity directly based on angle and power
-    m_velocityX = normalizedPower * cos(angle);
-    m_velocityY = normalizedPower * sin(angle);
+    BallPhysics::LaunchVelocity(power, angle, m_speedMultiplier, m_velocityX, m_velocityY);
     m_isMoving = true;
+    // The last shot's final step isn't the start of this one
+    m_prevPosX = m_posX;
+    m_prevPosY = m_posY;
 }
 
-void Ball::HandleCollision(Ball& other) {
-    float dx = other.m_posX - m_posX;
-    float dy = other.m_posY - m_posY;
-    float distance = sqrtf(dx * dx + dy * dy);
-    
-    if (distance < (m_radius + other.m_radius)) {
-        float nx = dx / distance;
-        float ny = dy / distance;
-        
-        float rvx = other.m_velocityX - m_velocityX;
-        float rvy = other.m_velocityY - m_velocityY;
-        
-        float velAlongNormal = rvx * nx + rvy * ny;
-        
-        if (velAlongNormal > 0) return;
-        
-        float restitution = 0.8f;
-        
-        float j = -(1.0f + restitution) * velAlongNormal;
-        j /= 1.0f / m_mass + 1.0f / other.m_mass;
-        
-        float impulseX = j * nx;
-        float impulseY = j * ny;
-        
-        m_velocityX -= impulseX / m_mass;
-        m_velocityY -= impulseY / m_mass;
-        other.m_velocityX += impulseX / other.m_mass;
-        other.m_velocityY += impulseY / other.m_mass;
+bool Ball::HandleCollision(Ball& other) {
+    BallPhysics::BallBody a = { m_posX, m_posY, m_velocityX, m_velocityY, m_radius, m_mass };
+    BallPhysics::BallBody b = { other.m_posX, other.m_posY, other.m_velocityX, other.m_velocityY, other.m_radius, other.m_mass };
+    if (!BallPhysics::ResolveBallContact(a, b)) return false;
 
-        // Cap velocities after collision
-        const float MAX_COLLISION_VELOCITY = 15.0f;
-        float speed = sqrt(m_velocityX * m_velocityX + m_velocityY * m_velocityY);
-        if (speed > MAX_COLLISION_VELOCITY) {
-            float scale = MAX_COLLISION_VELOCITY / speed;
-            m_velocityX *= scale;
-            m_velocityY *= scale;
-        }
-        
-        speed = sqrt(other.m_velocityX * other.m_velocityX + other.m_velocityY * other.m_velocityY);
-        if (speed > MAX_COLLISION_VELOCITY) {
-            float scale = MAX_COLLISION_VELOCITY / speed;
-            other.m_velocityX *= scale;
-            other.m_velocityY *= scale;
-        }
-        
-        float overlap = (m_radius + other.m_radius) - distance;
-        float moveX = (overlap * nx) * 0.5f;
-        float moveY = (overlap * ny) * 0.5f;
-        
-        m_posX -= moveX;
-        m_posY -= moveY;
-        other.m_posX += moveX;
-        other.m_posY += moveY;
-        
-        m_isMoving = true;
-        other.m_isMoving = true;
-    }
+    m_posX = a.x;
+    m_posY = a.y;
+    m_velocityX = a.vx;
+    m_velocityY = a.vy;
+    other.m_posX = b.x;
+    other.m_posY = b.y;
+    other.m_velocityX = b.vx;
+    other.m_velocityY = b.vy;
+
+    m_isMoving = true;
+    other.m_isMoving = true;
+    return true;
 }
 
 void Ball::DrawCircle(float x, float y, float radius, float r, float g, float b, float a) {
@@ -251,8 +172,6 @@ void Ball::Stop() {
     m_isMoving = false;
     m_velocityX = 0.0f;
     m_velocityY = 0.0f;
-    m_accelerationX = 0.0f;
-    m_accelerationY = 0.0f;
 }
 
 void Ball::SetVelocity(float vx, float vy) {
@@ -283,70 +202,42 @@ void Ball::GetInterpolatedPosition(float alpha, float& x, float& y) const {
 }
 
 void Ball::HandleBoundaryCollisions() {
-    const float BOUNCE_DAMPENING = 0.95f;
-    
-    if (m_posX < m_radius) {
-        m_posX = m_radius;
-        m_velocityX = fabs(m_velocityX) * BOUNCE_DAMPENING;
-        m_isMoving = true;
-    }
-    if (m_posX > SCREEN_WIDTH - m_radius) {
-        m_posX = SCREEN_WIDTH - m_radius;
-        m_velocityX = -fabs(m_velocityX) * BOUNCE_DAMPENING;
-        m_isMoving = true;
-    }
-    if (m_posY < m_radius) {
-        m_posY = m_radius;
-        m_velocityY = fabs(m_velocityY) * BOUNCE_DAMPENING;
-        m_isMoving = true;
-    }
-    if (m_posY > SCREEN_HEIGHT - m_radius) {
-        m_posY = SCREEN_HEIGHT - m_radius;
-        m_velocityY = -fabs(m_velocityY) * BOUNCE_DAMPENING;
-        m_isMoving = true;
+    BallPhysics::BallState state = GetPhysicsState();
+    if (BallPhysics::ResolveBoundary(state, m_physicsWorld ? *m_physicsWorld : GetScreenWorld())) {
+        ApplyPhysicsState(state);
     }
 }
 
-void Ball::HandleWallCollision(const Wall& wall) {
-    float wallLeft = wall.GetPosition().x - wall.GetWidth()/2;
-    float wallRight = wall.GetPosition().x + wall.GetWidth()/2;
-    float wallTop = wall.GetPosition().y - wall.GetHeight()/2;
-    float wallBottom = wall.GetPosition().y + wall.GetHeight()/2;
-
-    // Check if ball overlaps with wall
-    bool collision = false;
-    float penetrationX = 0.0f;
-    float penetrationY = 0.0f;
-
-    // Check horizontal overlap
-    if (m_posX + m_radius > wallLeft && m_posX - m_radius < wallRight) {
-        // Check vertical overlap
-        if (m_posY + m_radius > wallTop && m_posY - m_radius < wallBottom) {
-            collision = true;
-
-            // Calculate penetration depths
-            float rightPen = m_posX + m_radius - wallLeft;
-            float leftPen = wallRight - (m_posX - m_radius);
-            float bottomPen = m_posY + m_radius - wallTop;
-            float topPen = wallBottom - (m_posY - m_radius);
+bool Ball::HandleWallCollision(const Wall& wall) {
+    BallPhysics::BallState state = GetPhysicsState();
+    if (!BallPhysics::ResolveWallOverlap(state, wall.GetOrientedBox())) return false;
+    ApplyPhysicsState(state);
+    return true;
+}
 
-            // Find smallest penetration
-            float minPenX = (rightPen < leftPen) ? -rightPen : leftPen;
-            float minPenY = (bottomPen < topPen) ? -bottomPen : topPen;
+BallPhysics::BallState Ball::GetPhysicsState() const {
+    BallPhysics::BallState state;
+    state.x = m_posX;
+    state.y = m_posY;
+    state.vx = m_velocityX;
+    state.vy = m_velocityY;
+    state.radius = m_radius;
+    state.moving = m_isMoving;
+    state.ignoreWalls = m_phaseMode;
+    return state;
+}
 
-            // Determine which axis to resolve on based on minimum penetration
-            if (abs(minPenX) < abs(minPenY)) {
-                penetrationX = minPenX;
-                m_velocityX = -m_velocityX * BOUNCE_DAMPENING;
-            } else {
-                penetrationY = minPenY;
-                m_velocityY = -m_velocityY * BOUNCE_DAMPENING;
-            }
+void Ball::ApplyPhysicsState(const BallPhysics::BallState& state) {
+    m_posX = state.x;
+    m_posY = state.y;
+    m_velocityX = state.vx;
+    m_velocityY = state.vy;
+    m_isMoving = state.moving;
+}
 
-            // Move ball out of wall
-            m_posX += penetrationX;
-            m_posY += penetrationY;
-            m_isMoving = true;
-        }
-    }
-}
\ No newline at end of file
+BallPhysics::PhysicsWorld Ball::GetScreenWorld() const {
+    BallPhysics::PhysicsWorld world;
+    world.width = SCREEN_WIDTH;
+    world.height = SCREEN_HEIGHT;
+    return world;
+}
@@ -1,9 +1,11 @@
 #pragma once
 #include "GameObject.h"
+#include "ObjectArena.h"
 #include "App/app.h"
 #include "Wall.h"
 #include "Enemy.h"
 #include "Collectible.h"
+#include "BallPhysics.h"
 #include <vector>
 
 // Add screen constants
@@ -11,20 +13,21 @@ extern const float SCREEN_WIDTH;
 extern const float SCREEN_HEIGHT;
 
 class Ball : public GameObject {
+public:
+    static constexpr Type TYPE = Type::Ball;
+
 private:
-    static constexpr float BOUNCE_DAMPENING = 0.8f;
-    
     float m_prevPosX;
     float m_prevPosY;
     float m_velocityX;
     float m_velocityY;
-    float m_accelerationX;
-    float m_accelerationY;
-    float m_friction;
     float m_mass;
     float m_radius;
     bool m_isMoving;
-    float m_accumulator;
+
+    // Static geometry for the analytic integrator; owned by the Level
+    const BallPhysics::PhysicsWorld* m_physicsWorld = nullptr;
+    BallPhysics::Integrator m_integrator = BallPhysics::Integrator::Analytic;
 
     // Add powerup state variables
     float m_speedMultiplier = 1.0f;
@@ -35,13 +38,21 @@ private:
 
     static void DrawCircle(float x, float y, float radius, float r, float g, float b, float a);
 
+    BallPhysics::BallState GetPhysicsState() const;
+    void ApplyPhysicsState(const BallPhysics::BallState& state);
+    BallPhysics::PhysicsWorld GetScreenWorld() const;
+
 public:
     Ball(float x, float y);
     ~Ball() override = default;
     
     // GameObject interface implementation
-    void Update(float deltaTime) override;
+    void Update(SimSeconds deltaTime) override;
     void Draw() override;
+    // Draws the ball `alpha` of the way from its previous step to its current one
+    void DrawInterpolated(float alpha);
+    std::unique_ptr<GameObject> Clone() const override { return std::make_unique<Ball>(*this); }
+    GameObject* CloneInto(ObjectArena& arena) const override { return arena.Create<Ball>(*this); }
     bool CheckCollision(const GameObject& other) override;
     
     // Ball-specific methods
@@ -51,6 +62,11 @@ public:
     
     void GetInterpolatedPosition(float alpha, float& x, float& y) const;
     
+    // Integrator selection; FixedStep is kept as the reference path
+    void SetPhysicsWorld(const BallPhysics::PhysicsWorld* world) { m_physicsWorld = world; }
+    void SetIntegrator(BallPhysics::Integrator integrator) { m_integrator = integrator; }
+    BallPhysics::Integrator GetIntegrator() const { return m_integrator; }
+    
     // Velocity getters
     float GetVelocityX() const { return m_velocityX; }
     float GetVelocityY() const { return m_velocityY; }
@@ -60,9 +76,11 @@ public:
     bool IsMoving() const { return m_isMoving; }
     float GetRadius() const { return m_radius; }
     
-    void HandleCollision(Ball& other);
+    bool HandleCollision(Ball& other);
     void HandleBoundaryCollisions();
-    void HandleWallCollision(const Wall& wall);
+    bool HandleWallCollision(const Wall& wall);
+    bool HandleEnemyCollision(const Enemy& enemy);
+    bool HandleCollectibleCollision(Collectible& collectible);
     
     // Add these declarations
     void GetPosition(float& x, float& y) const override;
@@ -90,5 +108,7 @@ public:
 
     // Add this with the other powerup-related methods
     bool IsPhaseMode() const { return m_phaseMode; }
+    bool IsEnemyImmune() const { return m_enemyImmune; }
+    float GetSpeedMultiplier() const { return m_speedMultiplier; }
     bool IsProjectionLineEnabled() const { return m_projectionLineEnabled; }
 };
\ No newline at end of file
@@ -1,9 +1,10 @@
 #include "stdafx.h"
 #include "hole.h"
+#include "CollisionDispatch.h"
 #include <cmath>
 
 Hole::Hole(float startX, float startY, float holeX, float holeY, int par) :
-    GameObject(holeX, holeY),
+    GameObject(holeX, holeY, TYPE),
     m_startX(startX),
     m_startY(startY),
     m_holeX(holeX),
@@ -14,7 +15,7 @@ Hole::Hole(float startX, float startY, float holeX, float holeY, int par) :
     m_height = 20.0f;
 }
 
-void Hole::Update(float deltaTime) {
+void Hole::Update(SimSeconds deltaTime) {
     // Holes don't need updating in current implementation
     // But we could add animations or effects here
 }
@@ -44,30 +45,21 @@ void Hole::Draw() {
 }
 
 bool Hole::CheckCollision(const GameObject& other) {
-    const Ball* ball = dynamic_cast<const Ball*>(&other);
-    if (!ball) return false;
-    
-    float ballX, ballY;
-    ball->GetPosition(ballX, ballY);
-    
-    return IsInHole(ballX, ballY, ball->GetVelocityX(), ball->GetVelocityY());
+    return CollisionDispatch::Collide(*this, other);
 }
 
 bool Hole::IsInHole(float x, float y, float velocityX, float velocityY) const {
-    float dx = x - m_holeX;
-    float dy = y - m_holeY;
-    float distanceSquared = dx * dx + dy * dy;
-    
-    // Check if ball is over the hole
-    if (distanceSquared < (HOLE_RADIUS * HOLE_RADIUS)) {
-        // Calculate total velocity
-        float totalVelocity = sqrt(velocityX * velocityX + velocityY * velocityY);
-        
-        // Only allow entry if velocity is below maximum
-        return totalVelocity <= MAX_ENTRY_SPEED;
-    }
-    
-    return false;
+    return BallPhysics::IsInHole(GetTarget(), x, y, velocityX, velocityY);
+}
+
+BallPhysics::HoleTarget Hole::GetTarget() const {
+    BallPhysics::HoleTarget target;
+    target.x = m_holeX;
+    target.y = m_holeY;
+    target.radius = HOLE_RADIUS;
+    target.maxEntrySpeed = MAX_ENTRY_SPEED;
+    target.enabled = true;
+    return target;
 }
 
 void Hole::AddObstacle(float x, float y, float width, float height) {
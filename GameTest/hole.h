@@ -1,6 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include "GameObject.h"
+#include "ObjectArena.h"
 #include "Ball.h"
 #include <vector>
 #include "App/app.h"
@@ -15,13 +16,16 @@ struct Obstacle {
 };
 
 class Hole : public GameObject {
+public:
+    static constexpr Type TYPE = Type::Hole;
+
 private:
     float m_startX, m_startY;      // Starting position
     float m_holeX, m_holeY;        // Hole/target position
     std::vector<Obstacle> m_obstacles;
     int m_par;
     
-    static constexpr float MAX_ENTRY_SPEED = 0.2f;  // Updated to very slow speed
+    static constexpr float MAX_ENTRY_SPEED = 200.0f;  // Pixels per second; very slow
     static constexpr float HOLE_RADIUS = 10.0f;       // Hole radius
 
 public:
@@ -29,14 +33,18 @@ public:
     ~Hole() override = default;
     
     // GameObject interface implementation
-    void Update(float deltaTime) override;
+    void Update(SimSeconds deltaTime) override;
+    bool NeedsUpdate() const override { return false; }
     void Draw() override;
+    std::unique_ptr<GameObject> Clone() const override { return std::make_unique<Hole>(*this); }
+    GameObject* CloneInto(ObjectArena& arena) const override { return arena.Create<Hole>(*this); }
     bool CheckCollision(const GameObject& other) override;
     
     // Hole-specific methods
     bool IsInHole(float x, float y, float velocityX = 0.0f, float velocityY = 0.0f) const;
     void AddObstacle(float x, float y, float width, float height);
     bool CheckCollision(float x, float y) const;
+    BallPhysics::HoleTarget GetTarget() const;
     
     // Getters
     void GetStartPosition(float& x, float& y) const;